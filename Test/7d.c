@@ -23,15 +23,26 @@ int printf(const char *, ...);
 int fprintf(FILE *, const char *, ...);
 int snprintf(char *, int, const char *, ...);
 int strcmp(const char *, const char *);
+int strlen(const char *);
 char *strncpy(char *, const char *, int);
 char *strncat(char *, const char *, int);
 void *memset(void *, int, int);
+int atoi(const char *);
+long clock();
+void *malloc(unsigned long);
+void *realloc(void *, unsigned long);
+void free(void *);
+
+#define CLOCKS_PER_SEC 1000000
 #else
 typedef long long int64_t;
 typedef unsigned long long uint64_t;
 
 #ifdef _MSC_VER
 #define snprintf _snprintf
+#define CLOCKS_PER_SEC 1000
+#else
+#define CLOCKS_PER_SEC 1000000
 #endif
 
 int printf(const char *, ...);
@@ -44,906 +55,765 @@ int fwrite(const void *, int, int, FILE *);
 int fseek(FILE *, int, int);
 int fgetc(FILE *);
 int strcmp(const char *, const char *);
+int strlen(const char *);
 char *strncpy(char *, const char *, int);
 char *strncat(char *, const char *, int);
 void *memset(void *, int, int);
+int atoi(const char *);
+long clock();
+void *malloc(unsigned long);
+void *realloc(void *, unsigned long);
+void free(void *);
+void exit(int);
+
+int fflush(FILE *);
+int rename(const char *, const char *);
+
+#ifdef _MSC_VER
+void *__stdcall CreateThread(void *, unsigned long, unsigned long (__stdcall *)(void *), void *, unsigned long, unsigned long *);
+unsigned long __stdcall WaitForSingleObject(void *, unsigned long);
+int __stdcall CloseHandle(void *);
+unsigned long __stdcall GetActiveProcessorCount(unsigned short);
+__int64 _InterlockedExchangeAdd64(__int64 volatile *, __int64);
+#pragma intrinsic(_InterlockedExchangeAdd64)
+unsigned __int64 __rdtsc(void);
+#pragma intrinsic(__rdtsc)
+FILE *__cdecl __acrt_iob_func(unsigned);
+struct Stat  /* struct _stat64 */
+{
+    unsigned int st_dev;
+    unsigned short st_ino, st_mode;
+    short st_nlink, st_uid, st_gid;
+    unsigned int st_rdev;
+    __int64 st_size, st_atime, st_mtime, st_ctime;
+};
+int _stat64(const char *, struct Stat *);
+#define HAVE_STAT
+#define stdin (__acrt_iob_func(0))
+#define stdout (__acrt_iob_func(1))
+#else
+extern FILE *stdin, *stdout;
+#if defined(__linux__) && defined(__x86_64__)
+struct Stat  /* struct stat of x86_64 */
+{
+    unsigned long st_dev, st_ino, st_nlink;
+    unsigned int st_mode, st_uid, st_gid, pad0;
+    unsigned long st_rdev;
+    long st_size, st_blksize, st_blocks;
+    long st_atime, st_atime_nsec, st_mtime, st_mtime_nsec, st_ctime, st_ctime_nsec;
+    long unused[3];
+};
+#define HAVE_STAT
+#elif defined(__linux__) && (defined(__aarch64__) || (defined(__riscv) && __riscv_xlen == 64))
+struct Stat  /* the generic struct stat of 64-bit Linux */
+{
+    unsigned long st_dev, st_ino;
+    unsigned int st_mode, st_nlink, st_uid, st_gid;
+    unsigned long st_rdev, pad1;
+    long st_size;
+    int st_blksize, pad2;
+    long st_blocks;
+    long st_atime, st_atime_nsec, st_mtime, st_mtime_nsec, st_ctime, st_ctime_nsec;
+    int unused[2];
+};
+#define HAVE_STAT
+#endif
+#ifdef HAVE_STAT
+int stat(const char *, struct Stat *);
+#endif
+#ifdef __linux__
+long sysconf(int);
+#define _SC_NPROCESSORS_ONLN 84  /* glibc */
+#endif
+typedef unsigned long pthread_t;
+int pthread_create(pthread_t *, const void *, void *(*)(void *), void *);
+int pthread_join(pthread_t, void **);
+int open(const char *, int, ...);
+int close(int);
+long lseek(int, long, int);
+void *mmap(void *, unsigned long, int, int, int, long);
+int munmap(void *, unsigned long);
+#endif
 #endif
 
 /* Alpha declaration */
 
-enum Format
+#include "alpha.h"
+#include "elf.h"
+
+/* disassembler implementation */
+
+int get_index(uint32_t code)
 {
-    ___, Pcd, Bra, Mem, Mfc, Mbr, Opr, F_P
-};
+    const struct Decoder *d = &decoders[code >> 26];
+    int i = decode_tab[d->base + ((code >> d->shift) & d->mask)];
+    return (code & d->zero) ? 0 : i;
+}
 
-enum Format formats[] =
+enum Op get_op(uint32_t code)
 {
-    /* 00-07 */ Pcd, ___, ___, ___, ___, ___, ___, ___,
-    /* 08-0f */ Mem, Mem, Mem, Mem, Mem, Mem, Mem, Mem,
-    /* 10-17 */ Opr, Opr, Opr, Opr, F_P, F_P, F_P, F_P,
-    /* 18-1f */ Mfc, ___, Mbr, ___, Opr, ___, ___, ___,
-    /* 20-27 */ Mem, Mem, Mem, Mem, Mem, Mem, Mem, Mem,
-    /* 28-2f */ Mem, Mem, Mem, Mem, Mem, Mem, Mem, Mem,
-    /* 30-37 */ Bra, Bra, Bra, Bra, Bra, Bra, Bra, Bra,
-    /* 38-3f */ Bra, Bra, Bra, Bra, Bra, Bra, Bra, Bra,
-};
+    return opcodes[get_index(code)];
+}
 
-enum Regs
-{
-    /* r00     */ V0,
-    /* r01-r08 */ T0, T1, T2, T3, T4, T5, T6, T7,
-    /* r09-r14 */ S0, S1, S2, S3, S4, S5,
-    /* r15     */ FP,
-    /* r16-r21 */ A0, A1, A2, A3, A4, A5,
-    /* r22-r25 */ T8, T9, T10, T11,
-    /* r26     */ RA,
-    /* r27     */ T12,
-    /* r28     */ AT,
-    /* r29     */ GP,
-    /* r30     */ SP,
-    /* r31     */ Zero,
-};
+/* decoded instruction word: disp is the sign-extended Mem/Bra
+   displacement, the Mbr hint, the Opr literal (lit = 1), the Mfc
+   function or the Pcd number; target is the Bra destination */
 
-const char *regname[] =
-{
-    /* r00     */ "v0",
-    /* r01-r08 */ "t0", "t1", "t2", "t3", "t4", "t5", "t6", "t7",
-    /* r09-r14 */ "s0", "s1", "s2", "s3", "s4", "s5",
-    /* r15     */ "fp",
-    /* r16-r21 */ "a0", "a1", "a2", "a3", "a4", "a5",
-    /* r22-r25 */ "t8", "t9", "t10", "t11",
-    /* r26     */ "ra",
-    /* r27     */ "t12",
-    /* r28     */ "at",
-    /* r29     */ "gp",
-    /* r30     */ "sp",
-    /* r31     */ "zero",
+struct DecodedInsn
+{
+    uint32_t code;
+    short index;
+    unsigned char opc, format, ra, rb, rc, lit;
+    int disp;
+    uint64_t target;
 };
 
-const int reglen = sizeof(regname) / sizeof(const char *);
-
-enum Op
-{
-    UNDEF = -1,
-    Call_pal = 0x000000,
-    Opc01 = 0x010000,
-    Opc02 = 0x020000,
-    Opc03 = 0x030000,
-    Opc04 = 0x040000,
-    Opc05 = 0x050000,
-    Opc06 = 0x060000,
-    Opc07 = 0x070000,
-    Lda = 0x080000,
-    Ldah = 0x090000,
-    Ldbu = 0x0a0000,
-    Ldq_u = 0x0b0000,
-    Unop = 0x0b0001,
-    Ldwu = 0x0c0000,
-    Stw = 0x0d0000,
-    Stb = 0x0e0000,
-    Stq_u = 0x0f0000,
-    Addl = 0x100000,
-    S4addl = 0x100002,
-    Subl = 0x100009,
-    S4subl = 0x10000b,
-    Cmpbge = 0x10000f,
-    S8addl = 0x100012,
-    S8subl = 0x10001b,
-    Cmpult = 0x10001d,
-    Addq = 0x100020,
-    S4addq = 0x100022,
-    Subq = 0x100029,
-    S4subq = 0x10002b,
-    Cmpeq = 0x10002d,
-    S8addq = 0x100032,
-    S8subq = 0x10003b,
-    Cmpule = 0x10003d,
-    Addl__v = 0x100040,
-    Subl__v = 0x100049,
-    Cmplt = 0x10004d,
-    Addq__v = 0x100060,
-    Subq__v = 0x100069,
-    Cmple = 0x10006d,
-    And = 0x110000,
-    Bic = 0x110008,
-    Cmovlbs = 0x110014,
-    Cmovlbc = 0x110016,
-    Bis = 0x110020,
-    Cmoveq = 0x110024,
-    Cmovne = 0x110026,
-    Ornot = 0x110028,
-    Xor = 0x110040,
-    Cmovlt = 0x110044,
-    Cmovge = 0x110046,
-    Eqv = 0x110048,
-    Amask = 0x110061,
-    Cmovle = 0x110064,
-    Cmovgt = 0x110066,
-    Implver = 0x11006c,
-    Mskbl = 0x120002,
-    Extbl = 0x120006,
-    Insbl = 0x12000b,
-    Mskwl = 0x120012,
-    Extwl = 0x120016,
-    Inswl = 0x12001b,
-    Mskll = 0x120022,
-    Extll = 0x120026,
-    Insll = 0x12002b,
-    Zap = 0x120030,
-    Zapnot = 0x120031,
-    Mskql = 0x120032,
-    Srl = 0x120034,
-    Extql = 0x120036,
-    Sll = 0x120039,
-    Insql = 0x12003b,
-    Sra = 0x12003c,
-    Mskwh = 0x120052,
-    Inswh = 0x120057,
-    Extwh = 0x12005a,
-    Msklh = 0x120062,
-    Inslh = 0x120067,
-    Extlh = 0x12006a,
-    Mskqh = 0x120072,
-    Insqh = 0x120077,
-    Extqh = 0x12007a,
-    Mull = 0x130000,
-    Mulq = 0x130020,
-    Umulh = 0x130030,
-    Mull__v = 0x130040,
-    Mulq__v = 0x130060,
-    Itofs = 0x140004,
-    Sqrtf__c = 0x14000a,
-    Sqrts__c = 0x14000b,
-    Itoff = 0x140014,
-    Itoft = 0x140024,
-    Sqrtg__c = 0x14002a,
-    Sqrtt__c = 0x14002b,
-    Sqrts__m = 0x14004b,
-    Sqrtt__m = 0x14006b,
-    Sqrtf = 0x14008a,
-    Sqrts = 0x14008b,
-    Sqrtg = 0x1400aa,
-    Sqrtt = 0x1400ab,
-    Sqrts__d = 0x1400cb,
-    Sqrtt__d = 0x1400eb,
-    Sqrtf__uc = 0x14010a,
-    Sqrts__uc = 0x14010b,
-    Sqrtg__uc = 0x14012a,
-    Sqrtt__uc = 0x14012b,
-    Sqrts__um = 0x14014b,
-    Sqrtt__um = 0x14016b,
-    Sqrtf__u = 0x14018a,
-    Sqrts__u = 0x14018b,
-    Sqrtg__u = 0x1401aa,
-    Sqrtt__u = 0x1401ab,
-    Sqrts__ud = 0x1401cb,
-    Sqrtt__ud = 0x1401eb,
-    Sqrtf__sc = 0x14040a,
-    Sqrtg__sc = 0x14042a,
-    Sqrtf__s = 0x14048a,
-    Sqrtg__s = 0x1404aa,
-    Sqrtf__suc = 0x14050a,
-    Sqrts__suc = 0x14050b,
-    Sqrtg__suc = 0x14052a,
-    Sqrtt__suc = 0x14052b,
-    Sqrts__sum = 0x14054b,
-    Sqrtt__sum = 0x14056b,
-    Sqrtf__su = 0x14058a,
-    Sqrts__su = 0x14058b,
-    Sqrtg__su = 0x1405aa,
-    Sqrtt__su = 0x1405ab,
-    Sqrts__sud = 0x1405cb,
-    Sqrtt__sud = 0x1405eb,
-    Sqrts__suic = 0x14070b,
-    Sqrtt__suic = 0x14072b,
-    Sqrts__suim = 0x14074b,
-    Sqrtt__suim = 0x14076b,
-    Sqrts__sui = 0x14078b,
-    Sqrtt__sui = 0x1407ab,
-    Sqrts__suid = 0x1407cb,
-    Sqrtt__suid = 0x1407eb,
-    Addf__c = 0x150000,
-    Subf__c = 0x150001,
-    Mulf__c = 0x150002,
-    Divf__c = 0x150003,
-    Cvtdg__c = 0x15001e,
-    Addg__c = 0x150020,
-    Subg__c = 0x150021,
-    Mulg__c = 0x150022,
-    Divg__c = 0x150023,
-    Cvtgf__c = 0x15002c,
-    Cvtgd__c = 0x15002d,
-    Cvtgq__c = 0x15002f,
-    Cvtqf__c = 0x15003c,
-    Cvtqg__c = 0x15003e,
-    Addf = 0x150080,
-    Subf = 0x150081,
-    Mulf = 0x150082,
-    Divf = 0x150083,
-    Cvtdg = 0x15009e,
-    Addg = 0x1500a0,
-    Subg = 0x1500a1,
-    Mulg = 0x1500a2,
-    Divg = 0x1500a3,
-    Cmpgeq = 0x1500a5,
-    Cmpglt = 0x1500a6,
-    Cmpgle = 0x1500a7,
-    Cvtgf = 0x1500ac,
-    Cvtgd = 0x1500ad,
-    Cvtgq = 0x1500af,
-    Cvtqf = 0x1500bc,
-    Cvtqg = 0x1500be,
-    Addf__uc = 0x150100,
-    Subf__uc = 0x150101,
-    Mulf__uc = 0x150102,
-    Divf__uc = 0x150103,
-    Cvtdg__uc = 0x15011e,
-    Addg__uc = 0x150120,
-    Subg__uc = 0x150121,
-    Mulg__uc = 0x150122,
-    Divg__uc = 0x150123,
-    Cvtgf__uc = 0x15012c,
-    Cvtgd__uc = 0x15012d,
-    Cvtgq__vc = 0x15012f,
-    Addf__u = 0x150180,
-    Subf__u = 0x150181,
-    Mulf__u = 0x150182,
-    Divf__u = 0x150183,
-    Cvtdg__u = 0x15019e,
-    Addg__u = 0x1501a0,
-    Subg__u = 0x1501a1,
-    Mulg__u = 0x1501a2,
-    Divg__u = 0x1501a3,
-    Cvtgf__u = 0x1501ac,
-    Cvtgd__u = 0x1501ad,
-    Cvtgq__v = 0x1501af,
-    Addf__sc = 0x150400,
-    Subf__sc = 0x150401,
-    Mulf__sc = 0x150402,
-    Divf__sc = 0x150403,
-    Cvtdg__sc = 0x15041e,
-    Addg__sc = 0x150420,
-    Subg__sc = 0x150421,
-    Mulg__sc = 0x150422,
-    Divg__sc = 0x150423,
-    Cvtgf__sc = 0x15042c,
-    Cvtgd__sc = 0x15042d,
-    Cvtgq__sc = 0x15042f,
-    Addf__s = 0x150480,
-    Subf__s = 0x150481,
-    Mulf__s = 0x150482,
-    Divf__s = 0x150483,
-    Cvtdg__s = 0x15049e,
-    Addg__s = 0x1504a0,
-    Subg__s = 0x1504a1,
-    Mulg__s = 0x1504a2,
-    Divg__s = 0x1504a3,
-    Cmpgeq__s = 0x1504a5,
-    Cmpglt__s = 0x1504a6,
-    Cmpgle__s = 0x1504a7,
-    Cvtgf__s = 0x1504ac,
-    Cvtgd__s = 0x1504ad,
-    Cvtgq__s = 0x1504af,
-    Addf__suc = 0x150500,
-    Subf__suc = 0x150501,
-    Mulf__suc = 0x150502,
-    Divf__suc = 0x150503,
-    Cvtdg__suc = 0x15051e,
-    Addg__suc = 0x150520,
-    Subg__suc = 0x150521,
-    Mulg__suc = 0x150522,
-    Divg__suc = 0x150523,
-    Cvtgf__suc = 0x15052c,
-    Cvtgd__suc = 0x15052d,
-    Cvtgq__svc = 0x15052f,
-    Addf__su = 0x150580,
-    Subf__su = 0x150581,
-    Mulf__su = 0x150582,
-    Divf__su = 0x150583,
-    Cvtdg__su = 0x15059e,
-    Addg__su = 0x1505a0,
-    Subg__su = 0x1505a1,
-    Mulg__su = 0x1505a2,
-    Divg__su = 0x1505a3,
-    Cvtgf__su = 0x1505ac,
-    Cvtgd__su = 0x1505ad,
-    Cvtgq__sv = 0x1505af,
-    Adds__c = 0x160000,
-    Subs__c = 0x160001,
-    Muls__c = 0x160002,
-    Divs__c = 0x160003,
-    Addt__c = 0x160020,
-    Subt__c = 0x160021,
-    Mult__c = 0x160022,
-    Divt__c = 0x160023,
-    Cvtts__c = 0x16002c,
-    Cvttq__c = 0x16002f,
-    Cvtqs__c = 0x16003c,
-    Cvtqt__c = 0x16003e,
-    Adds__m = 0x160040,
-    Subs__m = 0x160041,
-    Muls__m = 0x160042,
-    Divs__m = 0x160043,
-    Addt__m = 0x160060,
-    Subt__m = 0x160061,
-    Mult__m = 0x160062,
-    Divt__m = 0x160063,
-    Cvtts__m = 0x16006c,
-    Cvttq__m = 0x16006f,
-    Cvtqs__m = 0x16007c,
-    Cvtqt__m = 0x16007e,
-    Adds = 0x160080,
-    Subs = 0x160081,
-    Muls = 0x160082,
-    Divs = 0x160083,
-    Addt = 0x1600a0,
-    Subt = 0x1600a1,
-    Mult = 0x1600a2,
-    Divt = 0x1600a3,
-    Cmptun = 0x1600a4,
-    Cmpteq = 0x1600a5,
-    Cmptlt = 0x1600a6,
-    Cmptle = 0x1600a7,
-    Cvtts = 0x1600ac,
-    Cvttq = 0x1600af,
-    Cvtqs = 0x1600bc,
-    Cvtqt = 0x1600be,
-    Adds__d = 0x1600c0,
-    Subs__d = 0x1600c1,
-    Muls__d = 0x1600c2,
-    Divs__d = 0x1600c3,
-    Addt__d = 0x1600e0,
-    Subt__d = 0x1600e1,
-    Mult__d = 0x1600e2,
-    Divt__d = 0x1600e3,
-    Cvtts__d = 0x1600ec,
-    Cvttq__d = 0x1600ef,
-    Cvtqs__d = 0x1600fc,
-    Cvtqt__d = 0x1600fe,
-    Adds__uc = 0x160100,
-    Subs__uc = 0x160101,
-    Muls__uc = 0x160102,
-    Divs__uc = 0x160103,
-    Addt__uc = 0x160120,
-    Subt__uc = 0x160121,
-    Mult__uc = 0x160122,
-    Divt__uc = 0x160123,
-    Cvtts__uc = 0x16012c,
-    Cvttq__vc = 0x16012f,
-    Adds__um = 0x160140,
-    Subs__um = 0x160141,
-    Muls__um = 0x160142,
-    Divs__um = 0x160143,
-    Addt__um = 0x160160,
-    Subt__um = 0x160161,
-    Mult__um = 0x160162,
-    Divt__um = 0x160163,
-    Cvtts__um = 0x16016c,
-    Cvttq__vm = 0x16016f,
-    Adds__u = 0x160180,
-    Subs__u = 0x160181,
-    Muls__u = 0x160182,
-    Divs__u = 0x160183,
-    Addt__u = 0x1601a0,
-    Subt__u = 0x1601a1,
-    Mult__u = 0x1601a2,
-    Divt__u = 0x1601a3,
-    Cvtts__u = 0x1601ac,
-    Cvttq__v = 0x1601af,
-    Adds__ud = 0x1601c0,
-    Subs__ud = 0x1601c1,
-    Muls__ud = 0x1601c2,
-    Divs__ud = 0x1601c3,
-    Addt__ud = 0x1601e0,
-    Subt__ud = 0x1601e1,
-    Mult__ud = 0x1601e2,
-    Divt__ud = 0x1601e3,
-    Cvtts__ud = 0x1601ec,
-    Cvttq__vd = 0x1601ef,
-    Cvtst = 0x1602ac,
-    Adds__suc = 0x160500,
-    Subs__suc = 0x160501,
-    Muls__suc = 0x160502,
-    Divs__suc = 0x160503,
-    Addt__suc = 0x160520,
-    Subt__suc = 0x160521,
-    Mult__suc = 0x160522,
-    Divt__suc = 0x160523,
-    Cvtts__suc = 0x16052c,
-    Cvttq__svc = 0x16052f,
-    Adds__sum = 0x160540,
-    Subs__sum = 0x160541,
-    Muls__sum = 0x160542,
-    Divs__sum = 0x160543,
-    Addt__sum = 0x160560,
-    Subt__sum = 0x160561,
-    Mult__sum = 0x160562,
-    Divt__sum = 0x160563,
-    Cvtts__sum = 0x16056c,
-    Cvttq__svm = 0x16056f,
-    Adds__su = 0x160580,
-    Subs__su = 0x160581,
-    Muls__su = 0x160582,
-    Divs__su = 0x160583,
-    Addt__su = 0x1605a0,
-    Subt__su = 0x1605a1,
-    Mult__su = 0x1605a2,
-    Divt__su = 0x1605a3,
-    Cmptun__su = 0x1605a4,
-    Cmpteq__su = 0x1605a5,
-    Cmptlt__su = 0x1605a6,
-    Cmptle__su = 0x1605a7,
-    Cvtts__su = 0x1605ac,
-    Cvttq__sv = 0x1605af,
-    Adds__sud = 0x1605c0,
-    Subs__sud = 0x1605c1,
-    Muls__sud = 0x1605c2,
-    Divs__sud = 0x1605c3,
-    Addt__sud = 0x1605e0,
-    Subt__sud = 0x1605e1,
-    Mult__sud = 0x1605e2,
-    Divt__sud = 0x1605e3,
-    Cvtts__sud = 0x1605ec,
-    Cvttq__svd = 0x1605ef,
-    Cvtst__s = 0x1606ac,
-    Adds__suic = 0x160700,
-    Subs__suic = 0x160701,
-    Muls__suic = 0x160702,
-    Divs__suic = 0x160703,
-    Addt__suic = 0x160720,
-    Subt__suic = 0x160721,
-    Mult__suic = 0x160722,
-    Divt__suic = 0x160723,
-    Cvtts__suic = 0x16072c,
-    Cvttq__svic = 0x16072f,
-    Cvtqs__suic = 0x16073c,
-    Cvtqt__suic = 0x16073e,
-    Adds__suim = 0x160740,
-    Subs__suim = 0x160741,
-    Muls__suim = 0x160742,
-    Divs__suim = 0x160743,
-    Addt__suim = 0x160760,
-    Subt__suim = 0x160761,
-    Mult__suim = 0x160762,
-    Divt__suim = 0x160763,
-    Cvtts__suim = 0x16076c,
-    Cvttq__svim = 0x16076f,
-    Cvtqs__suim = 0x16077c,
-    Cvtqt__suim = 0x16077e,
-    Adds__sui = 0x160780,
-    Subs__sui = 0x160781,
-    Muls__sui = 0x160782,
-    Divs__sui = 0x160783,
-    Addt__sui = 0x1607a0,
-    Subt__sui = 0x1607a1,
-    Mult__sui = 0x1607a2,
-    Divt__sui = 0x1607a3,
-    Cvtts__sui = 0x1607ac,
-    Cvttq__svi = 0x1607af,
-    Cvtqs__sui = 0x1607bc,
-    Cvtqt__sui = 0x1607be,
-    Adds__suid = 0x1607c0,
-    Subs__suid = 0x1607c1,
-    Muls__suid = 0x1607c2,
-    Divs__suid = 0x1607c3,
-    Addt__suid = 0x1607e0,
-    Subt__suid = 0x1607e1,
-    Mult__suid = 0x1607e2,
-    Divt__suid = 0x1607e3,
-    Cvtts__suid = 0x1607ec,
-    Cvttq__svid = 0x1607ef,
-    Cvtqs__suid = 0x1607fc,
-    Cvtqt__suid = 0x1607fe,
-    Cvtlq = 0x170010,
-    Cpys = 0x170020,
-    Cpysn = 0x170021,
-    Cpyse = 0x170022,
-    Mt_fpcr = 0x170024,
-    Mf_fpcr = 0x170025,
-    Fcmoveq = 0x17002a,
-    Fcmovne = 0x17002b,
-    Fcmovlt = 0x17002c,
-    Fcmovge = 0x17002d,
-    Fcmovle = 0x17002e,
-    Fcmovgt = 0x17002f,
-    Cvtql = 0x170030,
-    Cvtql__v = 0x170130,
-    Cvtql__sv = 0x170530,
-    Trapb = 0x180000,
-    Excb = 0x180400,
-    Mb = 0x184000,
-    Wmb = 0x184400,
-    Fetch = 0x188000,
-    Fetch_m = 0x18a000,
-    Rpcc = 0x18c000,
-    Rc = 0x18e000,
-    Ecb = 0x18e800,
-    Rs = 0x18f000,
-    Wh64 = 0x18f800,
-    Wh64en = 0x18fc00,
-    Pal19 = 0x190000,
-    Jmp = 0x1a0000,
-    Jsr = 0x1a0001,
-    Ret = 0x1a0002,
-    Jsr_coroutine = 0x1a0003,
-    Pal1b = 0x1b0000,
-    Sextb = 0x1c0000,
-    Sextw = 0x1c0001,
-    Ctpop = 0x1c0030,
-    Perr = 0x1c0031,
-    Ctlz = 0x1c0032,
-    Cttz = 0x1c0033,
-    Unpkbw = 0x1c0034,
-    Unpkbl = 0x1c0035,
-    Pkwb = 0x1c0036,
-    Pklb = 0x1c0037,
-    Minsb8 = 0x1c0038,
-    Minsw4 = 0x1c0039,
-    Minub8 = 0x1c003a,
-    Minuw4 = 0x1c003b,
-    Maxub8 = 0x1c003c,
-    Maxuw4 = 0x1c003d,
-    Maxsb8 = 0x1c003e,
-    Maxsw4 = 0x1c003f,
-    Ftoit = 0x1c0070,
-    Ftois = 0x1c0078,
-    Pal1d = 0x1d0000,
-    Pal1e = 0x1e0000,
-    Pal1f = 0x1f0000,
-    Ldf = 0x200000,
-    Ldg = 0x210000,
-    Lds = 0x220000,
-    Prefetch_m = 0x220001,
-    Ldt = 0x230000,
-    Prefetch_men = 0x230001,
-    Stf = 0x240000,
-    Stg = 0x250000,
-    Sts = 0x260000,
-    Stt = 0x270000,
-    Ldl = 0x280000,
-    Prefetch = 0x280001,
-    Ldq = 0x290000,
-    Prefetch_en = 0x290001,
-    Ldl_l = 0x2a0000,
-    Ldq_l = 0x2b0000,
-    Stl = 0x2c0000,
-    Stq = 0x2d0000,
-    Stl_c = 0x2e0000,
-    Stq_c = 0x2f0000,
-    Br = 0x300000,
-    Fbeq = 0x310000,
-    Fblt = 0x320000,
-    Fble = 0x330000,
-    Bsr = 0x340000,
-    Fbne = 0x350000,
-    Fbge = 0x360000,
-    Fbgt = 0x370000,
-    Blbc = 0x380000,
-    Beq = 0x390000,
-    Blt = 0x3a0000,
-    Ble = 0x3b0000,
-    Blbs = 0x3c0000,
-    Bne = 0x3d0000,
-    Bge = 0x3e0000,
-    Bgt = 0x3f0000,
-};
+void decode(struct DecodedInsn *d, uint64_t addr, uint32_t code)
+{
+    int opc = (int)(code >> 26);
+    d->code = code;
+    d->index = (short)get_index(code);
+    d->opc = (unsigned char)opc;
+    d->format = (unsigned char)formats[opc];
+    d->ra = (unsigned char)((code >> 21) & 31);
+    d->rb = (unsigned char)((code >> 16) & 31);
+    d->rc = (unsigned char)(code & 31);
+    d->lit = 0;
+    d->target = 0;
+    switch (formats[opc])
+    {
+    case Bra:
+        d->disp = (int)(code & 0x001fffff);
+        if (d->disp >= 0x00100000) d->disp -= 0x00200000;
+        d->target = addr + (int64_t)d->disp * 4 + 4;
+        break;
+    case Mem:
+        d->disp = (int16_t)(code & 0xffff);
+        break;
+    case Mfc:
+        d->disp = (int)(code & 0xffff);
+        break;
+    case Mbr:
+        d->disp = (int)(code & 0x3fff);
+        break;
+    case Opr:
+        d->lit = (unsigned char)((code >> 12) & 1);
+        d->disp = d->lit ? (int)((code >> 13) & 0xff) : 0;
+        break;
+    case F_P:
+        d->disp = 0;
+        break;
+    default:
+        d->disp = (int)(code & 0x03ffffff);
+        break;
+    }
+}
 
-const char *opnames[] =
-{
-    "addf", "addf/c", "addf/s", "addf/sc", "addf/su", "addf/suc", "addf/u", "addf/uc",
-    "addg", "addg/c", "addg/s", "addg/sc", "addg/su", "addg/suc", "addg/u", "addg/uc",
-    "addl", "addl/v", "addq", "addq/v", "adds", "adds/c", "adds/d", "adds/m",
-    "adds/su", "adds/suc", "adds/sud", "adds/sui", "adds/suic", "adds/suid", "adds/suim", "adds/sum",
-    "adds/u", "adds/uc", "adds/ud", "adds/um", "addt", "addt/c", "addt/d", "addt/m",
-    "addt/su", "addt/suc", "addt/sud", "addt/sui", "addt/suic", "addt/suid", "addt/suim", "addt/sum",
-    "addt/u", "addt/uc", "addt/ud", "addt/um", "amask", "and", "beq", "bge",
-    "bgt", "bic", "bis", "blbc", "blbs", "ble", "blt", "bne",
-    "br", "bsr", "call_pal", "cmoveq", "cmovge", "cmovgt", "cmovlbc", "cmovlbs",
-    "cmovle", "cmovlt", "cmovne", "cmpbge", "cmpeq", "cmpgeq", "cmpgeq/s", "cmpgle",
-    "cmpgle/s", "cmpglt", "cmpglt/s", "cmple", "cmplt", "cmpteq", "cmpteq/su", "cmptle",
-    "cmptle/su", "cmptlt", "cmptlt/su", "cmptun", "cmptun/su", "cmpule", "cmpult", "cpys",
-    "cpyse", "cpysn", "ctlz", "ctpop", "cttz", "cvtdg", "cvtdg/c", "cvtdg/s",
-    "cvtdg/sc", "cvtdg/su", "cvtdg/suc", "cvtdg/u", "cvtdg/uc", "cvtgd", "cvtgd/c", "cvtgd/s",
-    "cvtgd/sc", "cvtgd/su", "cvtgd/suc", "cvtgd/u", "cvtgd/uc", "cvtgf", "cvtgf/c", "cvtgf/s",
-    "cvtgf/sc", "cvtgf/su", "cvtgf/suc", "cvtgf/u", "cvtgf/uc", "cvtgq", "cvtgq/c", "cvtgq/s",
-    "cvtgq/sc", "cvtgq/sv", "cvtgq/svc", "cvtgq/v", "cvtgq/vc", "cvtlq", "cvtqf", "cvtqf/c",
-    "cvtqg", "cvtqg/c", "cvtql", "cvtql/sv", "cvtql/v", "cvtqs", "cvtqs/c", "cvtqs/d",
-    "cvtqs/m", "cvtqs/sui", "cvtqs/suic", "cvtqs/suid", "cvtqs/suim", "cvtqt", "cvtqt/c", "cvtqt/d",
-    "cvtqt/m", "cvtqt/sui", "cvtqt/suic", "cvtqt/suid", "cvtqt/suim", "cvtst", "cvtst/s", "cvttq",
-    "cvttq/c", "cvttq/d", "cvttq/m", "cvttq/sv", "cvttq/svc", "cvttq/svd", "cvttq/svi", "cvttq/svic",
-    "cvttq/svid", "cvttq/svim", "cvttq/svm", "cvttq/v", "cvttq/vc", "cvttq/vd", "cvttq/vm", "cvtts",
-    "cvtts/c", "cvtts/d", "cvtts/m", "cvtts/su", "cvtts/suc", "cvtts/sud", "cvtts/sui", "cvtts/suic",
-    "cvtts/suid", "cvtts/suim", "cvtts/sum", "cvtts/u", "cvtts/uc", "cvtts/ud", "cvtts/um", "divf",
-    "divf/c", "divf/s", "divf/sc", "divf/su", "divf/suc", "divf/u", "divf/uc", "divg",
-    "divg/c", "divg/s", "divg/sc", "divg/su", "divg/suc", "divg/u", "divg/uc", "divs",
-    "divs/c", "divs/d", "divs/m", "divs/su", "divs/suc", "divs/sud", "divs/sui", "divs/suic",
-    "divs/suid", "divs/suim", "divs/sum", "divs/u", "divs/uc", "divs/ud", "divs/um", "divt",
-    "divt/c", "divt/d", "divt/m", "divt/su", "divt/suc", "divt/sud", "divt/sui", "divt/suic",
-    "divt/suid", "divt/suim", "divt/sum", "divt/u", "divt/uc", "divt/ud", "divt/um", "ecb",
-    "eqv", "excb", "extbl", "extlh", "extll", "extqh", "extql", "extwh",
-    "extwl", "fbeq", "fbge", "fbgt", "fble", "fblt", "fbne", "fcmoveq",
-    "fcmovge", "fcmovgt", "fcmovle", "fcmovlt", "fcmovne", "fetch", "fetch_m", "ftois",
-    "ftoit", "implver", "insbl", "inslh", "insll", "insqh", "insql", "inswh",
-    "inswl", "itoff", "itofs", "itoft", "jmp", "jsr", "jsr_coroutine", "lda",
-    "ldah", "ldbu", "ldf", "ldg", "ldl", "ldl_l", "ldq", "ldq_l",
-    "ldq_u", "lds", "ldt", "ldwu", "maxsb8", "maxsw4", "maxub8", "maxuw4",
-    "mb", "mf_fpcr", "minsb8", "minsw4", "minub8", "minuw4", "mskbl", "msklh",
-    "mskll", "mskqh", "mskql", "mskwh", "mskwl", "mt_fpcr", "mulf", "mulf/c",
-    "mulf/s", "mulf/sc", "mulf/su", "mulf/suc", "mulf/u", "mulf/uc", "mulg", "mulg/c",
-    "mulg/s", "mulg/sc", "mulg/su", "mulg/suc", "mulg/u", "mulg/uc", "mull", "mull/v",
-    "mulq", "mulq/v", "muls", "muls/c", "muls/d", "muls/m", "muls/su", "muls/suc",
-    "muls/sud", "muls/sui", "muls/suic", "muls/suid", "muls/suim", "muls/sum", "muls/u", "muls/uc",
-    "muls/ud", "muls/um", "mult", "mult/c", "mult/d", "mult/m", "mult/su", "mult/suc",
-    "mult/sud", "mult/sui", "mult/suic", "mult/suid", "mult/suim", "mult/sum", "mult/u", "mult/uc",
-    "mult/ud", "mult/um", "opc01", "opc02", "opc03", "opc04", "opc05", "opc06",
-    "opc07", "ornot", "pal19", "pal1b", "pal1d", "pal1e", "pal1f", "perr",
-    "pklb", "pkwb", "prefetch", "prefetch_en", "prefetch_m", "prefetch_men", "rc", "ret",
-    "rpcc", "rs", "s4addl", "s4addq", "s4subl", "s4subq", "s8addl", "s8addq",
-    "s8subl", "s8subq", "sextb", "sextw", "sll", "sqrtf", "sqrtf/c", "sqrtf/s",
-    "sqrtf/sc", "sqrtf/su", "sqrtf/suc", "sqrtf/u", "sqrtf/uc", "sqrtg", "sqrtg/c", "sqrtg/s",
-    "sqrtg/sc", "sqrtg/su", "sqrtg/suc", "sqrtg/u", "sqrtg/uc", "sqrts", "sqrts/c", "sqrts/d",
-    "sqrts/m", "sqrts/su", "sqrts/suc", "sqrts/sud", "sqrts/sui", "sqrts/suic", "sqrts/suid", "sqrts/suim",
-    "sqrts/sum", "sqrts/u", "sqrts/uc", "sqrts/ud", "sqrts/um", "sqrtt", "sqrtt/c", "sqrtt/d",
-    "sqrtt/m", "sqrtt/su", "sqrtt/suc", "sqrtt/sud", "sqrtt/sui", "sqrtt/suic", "sqrtt/suid", "sqrtt/suim",
-    "sqrtt/sum", "sqrtt/u", "sqrtt/uc", "sqrtt/ud", "sqrtt/um", "sra", "srl", "stb",
-    "stf", "stg", "stl", "stl_c", "stq", "stq_c", "stq_u", "sts",
-    "stt", "stw", "subf", "subf/c", "subf/s", "subf/sc", "subf/su", "subf/suc",
-    "subf/u", "subf/uc", "subg", "subg/c", "subg/s", "subg/sc", "subg/su", "subg/suc",
-    "subg/u", "subg/uc", "subl", "subl/v", "subq", "subq/v", "subs", "subs/c",
-    "subs/d", "subs/m", "subs/su", "subs/suc", "subs/sud", "subs/sui", "subs/suic", "subs/suid",
-    "subs/suim", "subs/sum", "subs/u", "subs/uc", "subs/ud", "subs/um", "subt", "subt/c",
-    "subt/d", "subt/m", "subt/su", "subt/suc", "subt/sud", "subt/sui", "subt/suic", "subt/suid",
-    "subt/suim", "subt/sum", "subt/u", "subt/uc", "subt/ud", "subt/um", "trapb", "umulh",
-    "unop", "unpkbl", "unpkbw", "wh64", "wh64en", "wmb", "xor", "zap",
-    "zapnot",
-};
+void decode_text(struct DecodedInsn *d, uint64_t addr, const char *text, int count)
+{
+    int i;
+    for (i = 0; i < count; i++, d++, addr += 4)
+        decode(d, addr, *(const uint32_t *)&text[i * 4]);
+}
 
-enum Op opcodes[] =
-{
-    Addf, Addf__c, Addf__s, Addf__sc, Addf__su, Addf__suc, Addf__u, Addf__uc,
-    Addg, Addg__c, Addg__s, Addg__sc, Addg__su, Addg__suc, Addg__u, Addg__uc,
-    Addl, Addl__v, Addq, Addq__v, Adds, Adds__c, Adds__d, Adds__m,
-    Adds__su, Adds__suc, Adds__sud, Adds__sui, Adds__suic, Adds__suid, Adds__suim, Adds__sum,
-    Adds__u, Adds__uc, Adds__ud, Adds__um, Addt, Addt__c, Addt__d, Addt__m,
-    Addt__su, Addt__suc, Addt__sud, Addt__sui, Addt__suic, Addt__suid, Addt__suim, Addt__sum,
-    Addt__u, Addt__uc, Addt__ud, Addt__um, Amask, And, Beq, Bge,
-    Bgt, Bic, Bis, Blbc, Blbs, Ble, Blt, Bne,
-    Br, Bsr, Call_pal, Cmoveq, Cmovge, Cmovgt, Cmovlbc, Cmovlbs,
-    Cmovle, Cmovlt, Cmovne, Cmpbge, Cmpeq, Cmpgeq, Cmpgeq__s, Cmpgle,
-    Cmpgle__s, Cmpglt, Cmpglt__s, Cmple, Cmplt, Cmpteq, Cmpteq__su, Cmptle,
-    Cmptle__su, Cmptlt, Cmptlt__su, Cmptun, Cmptun__su, Cmpule, Cmpult, Cpys,
-    Cpyse, Cpysn, Ctlz, Ctpop, Cttz, Cvtdg, Cvtdg__c, Cvtdg__s,
-    Cvtdg__sc, Cvtdg__su, Cvtdg__suc, Cvtdg__u, Cvtdg__uc, Cvtgd, Cvtgd__c, Cvtgd__s,
-    Cvtgd__sc, Cvtgd__su, Cvtgd__suc, Cvtgd__u, Cvtgd__uc, Cvtgf, Cvtgf__c, Cvtgf__s,
-    Cvtgf__sc, Cvtgf__su, Cvtgf__suc, Cvtgf__u, Cvtgf__uc, Cvtgq, Cvtgq__c, Cvtgq__s,
-    Cvtgq__sc, Cvtgq__sv, Cvtgq__svc, Cvtgq__v, Cvtgq__vc, Cvtlq, Cvtqf, Cvtqf__c,
-    Cvtqg, Cvtqg__c, Cvtql, Cvtql__sv, Cvtql__v, Cvtqs, Cvtqs__c, Cvtqs__d,
-    Cvtqs__m, Cvtqs__sui, Cvtqs__suic, Cvtqs__suid, Cvtqs__suim, Cvtqt, Cvtqt__c, Cvtqt__d,
-    Cvtqt__m, Cvtqt__sui, Cvtqt__suic, Cvtqt__suid, Cvtqt__suim, Cvtst, Cvtst__s, Cvttq,
-    Cvttq__c, Cvttq__d, Cvttq__m, Cvttq__sv, Cvttq__svc, Cvttq__svd, Cvttq__svi, Cvttq__svic,
-    Cvttq__svid, Cvttq__svim, Cvttq__svm, Cvttq__v, Cvttq__vc, Cvttq__vd, Cvttq__vm, Cvtts,
-    Cvtts__c, Cvtts__d, Cvtts__m, Cvtts__su, Cvtts__suc, Cvtts__sud, Cvtts__sui, Cvtts__suic,
-    Cvtts__suid, Cvtts__suim, Cvtts__sum, Cvtts__u, Cvtts__uc, Cvtts__ud, Cvtts__um, Divf,
-    Divf__c, Divf__s, Divf__sc, Divf__su, Divf__suc, Divf__u, Divf__uc, Divg,
-    Divg__c, Divg__s, Divg__sc, Divg__su, Divg__suc, Divg__u, Divg__uc, Divs,
-    Divs__c, Divs__d, Divs__m, Divs__su, Divs__suc, Divs__sud, Divs__sui, Divs__suic,
-    Divs__suid, Divs__suim, Divs__sum, Divs__u, Divs__uc, Divs__ud, Divs__um, Divt,
-    Divt__c, Divt__d, Divt__m, Divt__su, Divt__suc, Divt__sud, Divt__sui, Divt__suic,
-    Divt__suid, Divt__suim, Divt__sum, Divt__u, Divt__uc, Divt__ud, Divt__um, Ecb,
-    Eqv, Excb, Extbl, Extlh, Extll, Extqh, Extql, Extwh,
-    Extwl, Fbeq, Fbge, Fbgt, Fble, Fblt, Fbne, Fcmoveq,
-    Fcmovge, Fcmovgt, Fcmovle, Fcmovlt, Fcmovne, Fetch, Fetch_m, Ftois,
-    Ftoit, Implver, Insbl, Inslh, Insll, Insqh, Insql, Inswh,
-    Inswl, Itoff, Itofs, Itoft, Jmp, Jsr, Jsr_coroutine, Lda,
-    Ldah, Ldbu, Ldf, Ldg, Ldl, Ldl_l, Ldq, Ldq_l,
-    Ldq_u, Lds, Ldt, Ldwu, Maxsb8, Maxsw4, Maxub8, Maxuw4,
-    Mb, Mf_fpcr, Minsb8, Minsw4, Minub8, Minuw4, Mskbl, Msklh,
-    Mskll, Mskqh, Mskql, Mskwh, Mskwl, Mt_fpcr, Mulf, Mulf__c,
-    Mulf__s, Mulf__sc, Mulf__su, Mulf__suc, Mulf__u, Mulf__uc, Mulg, Mulg__c,
-    Mulg__s, Mulg__sc, Mulg__su, Mulg__suc, Mulg__u, Mulg__uc, Mull, Mull__v,
-    Mulq, Mulq__v, Muls, Muls__c, Muls__d, Muls__m, Muls__su, Muls__suc,
-    Muls__sud, Muls__sui, Muls__suic, Muls__suid, Muls__suim, Muls__sum, Muls__u, Muls__uc,
-    Muls__ud, Muls__um, Mult, Mult__c, Mult__d, Mult__m, Mult__su, Mult__suc,
-    Mult__sud, Mult__sui, Mult__suic, Mult__suid, Mult__suim, Mult__sum, Mult__u, Mult__uc,
-    Mult__ud, Mult__um, Opc01, Opc02, Opc03, Opc04, Opc05, Opc06,
-    Opc07, Ornot, Pal19, Pal1b, Pal1d, Pal1e, Pal1f, Perr,
-    Pklb, Pkwb, Prefetch, Prefetch_en, Prefetch_m, Prefetch_men, Rc, Ret,
-    Rpcc, Rs, S4addl, S4addq, S4subl, S4subq, S8addl, S8addq,
-    S8subl, S8subq, Sextb, Sextw, Sll, Sqrtf, Sqrtf__c, Sqrtf__s,
-    Sqrtf__sc, Sqrtf__su, Sqrtf__suc, Sqrtf__u, Sqrtf__uc, Sqrtg, Sqrtg__c, Sqrtg__s,
-    Sqrtg__sc, Sqrtg__su, Sqrtg__suc, Sqrtg__u, Sqrtg__uc, Sqrts, Sqrts__c, Sqrts__d,
-    Sqrts__m, Sqrts__su, Sqrts__suc, Sqrts__sud, Sqrts__sui, Sqrts__suic, Sqrts__suid, Sqrts__suim,
-    Sqrts__sum, Sqrts__u, Sqrts__uc, Sqrts__ud, Sqrts__um, Sqrtt, Sqrtt__c, Sqrtt__d,
-    Sqrtt__m, Sqrtt__su, Sqrtt__suc, Sqrtt__sud, Sqrtt__sui, Sqrtt__suic, Sqrtt__suid, Sqrtt__suim,
-    Sqrtt__sum, Sqrtt__u, Sqrtt__uc, Sqrtt__ud, Sqrtt__um, Sra, Srl, Stb,
-    Stf, Stg, Stl, Stl_c, Stq, Stq_c, Stq_u, Sts,
-    Stt, Stw, Subf, Subf__c, Subf__s, Subf__sc, Subf__su, Subf__suc,
-    Subf__u, Subf__uc, Subg, Subg__c, Subg__s, Subg__sc, Subg__su, Subg__suc,
-    Subg__u, Subg__uc, Subl, Subl__v, Subq, Subq__v, Subs, Subs__c,
-    Subs__d, Subs__m, Subs__su, Subs__suc, Subs__sud, Subs__sui, Subs__suic, Subs__suid,
-    Subs__suim, Subs__sum, Subs__u, Subs__uc, Subs__ud, Subs__um, Subt, Subt__c,
-    Subt__d, Subt__m, Subt__su, Subt__suc, Subt__sud, Subt__sui, Subt__suic, Subt__suid,
-    Subt__suim, Subt__sum, Subt__u, Subt__uc, Subt__ud, Subt__um, Trapb, Umulh,
-    Unop, Unpkbl, Unpkbw, Wh64, Wh64en, Wmb, Xor, Zap,
-    Zapnot,
-};
+struct Elf elf;
+uint64_t text_addr, text_size;
+int text_shndx;
+const char *text_buf;
+struct DecodedInsn *insns;
 
-const int oplen = sizeof(opnames) / sizeof(const char *);
-
-const char *op00[1], *op01[1], *op02[1], *op03[1];
-const char *op04[1], *op05[1], *op06[1], *op07[1];
-const char *op08[1], *op09[1], *op0a[1], *op0b[2];
-const char *op0c[1], *op0d[1], *op0e[1], *op0f[1];
-const char *op10[0x80], *op11[0x80], *op12[0x80], *op13[0x80];
-const char *op14[0x800], *op15[0x800], *op16[0x800], *op17[0x800];
-const char *op18[] = { "pal18" }, *op19[1], *op1a[4], *op1b[1];
-const char *op1c[0x80], *op1d[1], *op1e[1], *op1f[1];
-const char *op20[1], *op21[1], *op22[2], *op23[2];
-const char *op24[1], *op25[1], *op26[1], *op27[1];
-const char *op28[2], *op29[2], *op2a[1], *op2b[1];
-const char *op2c[1], *op2d[1], *op2e[1], *op2f[1];
-const char *op30[1], *op31[1], *op32[1], *op33[1];
-const char *op34[1], *op35[1], *op36[1], *op37[1];
-const char *op38[1], *op39[1], *op3a[1], *op3b[1];
-const char *op3c[1], *op3d[1], *op3e[1], *op3f[1];
-
-const char **subops[] =
-{
-    op00, op01, op02, op03, op04, op05, op06, op07,
-    op08, op09, op0a, op0b, op0c, op0d, op0e, op0f,
-    op10, op11, op12, op13, op14, op15, op16, op17,
-    op18, op19, op1a, op1b, op1c, op1d, op1e, op1f,
-    op20, op21, op22, op23, op24, op25, op26, op27,
-    op28, op29, op2a, op2b, op2c, op2d, op2e, op2f,
-    op30, op31, op32, op33, op34, op35, op36, op37,
-    op38, op39, op3a, op3b, op3c, op3d, op3e, op3f,
-};
+/* control flow graph: leaders are the words after every branch, jump
+   and return, the targets of branches inside .text and the boundaries
+   of code and data; blocks run from a leader to the next one */
 
-enum POp
+#define LEADER 1
+#define TARGET 2
+#define DATA 4
+
+struct Block
 {
-    Mov, Nop, Clr,
-    Sextl, Not, Negl, Negl__v, Negq, Negq__v,
-    Fnop, Fclr, Fabs, Fmov, Fneg,
-    Negf, Negf__s, Negg, Negg__s,
-    Negs, Negs__su, Negs__sui, Negt, Negt__su, Negt__sui
+    int start, end;  /* insns index range */
+    int succ[2];     /* fall through and branch target, -1: none */
 };
 
-const char *popnames[] =
+unsigned char *leaders;
+int *block_index;    /* block of each leader word */
+struct Block *blocks;
+int block_count;
+
+int text_index(uint64_t ad)
+{
+    uint64_t off = ad - text_addr;
+    return off < text_size && (off & 3) == 0 ? (int)(off / 4) : -1;
+}
+
+int ends_block(const struct DecodedInsn *d)
+{
+    return d->format == Bra || d->format == Mbr;
+}
+
+int classify_text(int words);
+
+int build_cfg(int words)
+{
+    int i, b;
+    leaders = (unsigned char *)realloc(leaders, words + 1);
+    block_index = (int *)realloc(block_index, (words + 1) * sizeof(int));
+    if (!leaders || !block_index)
+    {
+        printf("can not allocate control flow graph\n");
+        return 0;
+    }
+    memset(leaders, 0, words + 1);
+    if (!classify_text(words)) return 0;
+    if (words > 0) leaders[0] |= LEADER;
+    for (i = 0; i < words; i++)
+    {
+        const struct DecodedInsn *d = &insns[i];
+        if (i > 0 && ((leaders[i] ^ leaders[i - 1]) & DATA)) leaders[i] |= LEADER;
+        if ((leaders[i] & DATA) || !ends_block(d)) continue;
+        leaders[i + 1] |= LEADER;
+        if (d->format == Bra)
+        {
+            int t = text_index(d->target);
+            if (t >= 0) leaders[t] |= LEADER | TARGET;
+        }
+    }
+    for (i = 0, block_count = 0; i < words; i++)
+        if (leaders[i] & LEADER) block_index[i] = block_count++;
+    blocks = (struct Block *)realloc(blocks, (block_count + 1) * sizeof(struct Block));
+    if (!blocks)
+    {
+        printf("can not allocate control flow graph\n");
+        return 0;
+    }
+    for (i = 0, b = -1; i <= words; i++)
+    {
+        const struct DecodedInsn *d;
+        struct Block *bl;
+        int t;
+        if (i < words && !(leaders[i] & LEADER)) continue;
+        if (b >= 0)
+        {
+            bl = &blocks[b];
+            bl->end = i;
+            d = &insns[i - 1];
+            bl->succ[0] = i < words ? b + 1 : -1;
+            bl->succ[1] = -1;
+            if (d->format == Bra)
+            {
+                enum Op op = opcodes[d->index];
+                if ((t = text_index(d->target)) >= 0) bl->succ[1] = block_index[t];
+                if (op == Br) bl->succ[0] = -1;
+            }
+            else if (d->format == Mbr)
+            {
+                enum Op op = opcodes[d->index];
+                if (op == Jmp || op == Ret) bl->succ[0] = -1;
+            }
+        }
+        if (i < words) blocks[++b].start = i;
+    }
+    return 1;
+}
+
+int is_label(uint64_t ad)
+{
+    int i = text_index(ad);
+    return i >= 0 && (leaders[i] & TARGET) != 0;
+}
+
+/* symbols: the functions and untyped symbols of .text in .symtab.
+   sym_index is an interval index over the words: each word holds the
+   symbol containing it (-1: none), so any address is looked up in O(1).
+   A symbol without a size runs up to the next one */
+
+#define NAME_MAX 64
+
+struct Symbol
 {
-    "mov", "nop", "clr",
-    "sextl", "not", "negl", "negl/v", "negq", "negq/v",
-    "fnop", "fclr", "fabs", "fmov", "fneg",
-    "negf", "negf/s", "negg", "negg/s",
-    "negs", "negs/su", "negs/sui", "negt", "negt/su", "negt/sui"
+    uint64_t addr, size;
+    const char *name;   /* in .strtab */
+    int label;          /* name can be written as a 7a label */
 };
 
-enum Op popcodes[] =
+struct Symbol *symbols;
+int symbol_count;
+int *sym_index;
+
+/* a label must be a 7a symbol which is not a register name nor looks
+   like the Lxxxxxxxx labels of branch targets */
+int is_label_name(const char *s)
+{
+    int i, len, digits = 0;
+    if (!(('A' <= *s && *s <= 'Z') || ('a' <= *s && *s <= 'z') || *s == '_')) return 0;
+    for (len = 1; s[len]; len++)
+    {
+        int ch = s[len];
+        if ('0' <= ch && ch <= '9')
+            digits++;
+        else if (!(('A' <= ch && ch <= 'Z') || ('a' <= ch && ch <= 'z') || ch == '_'))
+            return 0;
+        if (len >= NAME_MAX) return 0;
+    }
+    if (len == 9 && *s == 'L') return 0;
+    if (digits == len - 1 && len <= 3) return 0;
+    for (i = 0; i < reglen; i++)
+    {
+        const char *a = s, *b = regname[i];
+        for (; *a && (*a | 0x20) == *b; a++, b++);
+        if (!*a && !*b) return 0;
+    }
+    return 1;
+}
+
+uint32_t hash_name(const char *s)
+{
+    uint32_t h = 2166136261u;
+    for (; *s; s++) h = (h ^ (unsigned char)*s) * 16777619u;
+    return h;
+}
+
+/* names defined more than once can not be labels */
+int check_duplicates()
+{
+    int i, mask = 1, *slots;
+    while (mask < symbol_count * 2) mask <<= 1;
+    if (!(slots = (int *)malloc(mask * sizeof(int)))) return 0;
+    memset(slots, -1, mask * sizeof(int));
+    mask--;
+    for (i = 0; i < symbol_count; i++)
+    {
+        int h;
+        if (!symbols[i].label) continue;
+        for (h = (int)(hash_name(symbols[i].name) & mask); slots[h] >= 0; h = (h + 1) & mask)
+        {
+            struct Symbol *sym = &symbols[slots[h]];
+            if (strcmp(sym->name, symbols[i].name) == 0)
+            {
+                sym->label = symbols[i].label = 0;
+                break;
+            }
+        }
+        if (slots[h] < 0) slots[h] = i;
+    }
+    free(slots);
+    return 1;
+}
+
+int load_symbols(int words)
+{
+    const struct Elf64_Sym *syms;
+    const char *strtab;
+    uint64_t strsize;
+    int i, count = 0, cur = -1, end = 0;
+    sym_index = (int *)realloc(sym_index, (words + 1) * sizeof(int));
+    if (!sym_index)
+    {
+        printf("can not allocate symbol index\n");
+        return 0;
+    }
+    memset(sym_index, -1, (words + 1) * sizeof(int));
+    symbol_count = 0;
+    if (!elf.ehdr || !(syms = elf_symtab(&elf, &count, &strtab, &strsize))) return 1;
+    symbols = (struct Symbol *)realloc(symbols, (count + 1) * sizeof(struct Symbol));
+    if (!symbols)
+    {
+        printf("can not allocate symbols\n");
+        return 0;
+    }
+    for (i = 0; i < count; i++)
+    {
+        const struct Elf64_Sym *sym = &syms[i];
+        int type = sym->st_info & 15, w = text_index(sym->st_value);
+        struct Symbol *s;
+        if (sym->st_shndx != text_shndx || (type != 0 /* STT_NOTYPE */ && type != 2 /* STT_FUNC */)
+            || sym->st_name == 0 || sym->st_name >= strsize)
+            continue;
+        if (w < 0)
+        {
+            /* a symbol running into a range from before it */
+            if (sym->st_value >= text_addr
+                || (sym->st_size != 0 && sym->st_value + sym->st_size <= text_addr))
+                continue;
+            w = 0;
+        }
+        s = &symbols[symbol_count];
+        s->addr = sym->st_value;
+        s->size = sym->st_size;
+        s->name = strtab + sym->st_name;
+        s->label = is_label_name(s->name);
+        /* the nearest start wins, then the first symbol with a size */
+        if (sym_index[w] < 0 || s->addr > symbols[sym_index[w]].addr
+            || (s->addr == symbols[sym_index[w]].addr && symbols[sym_index[w]].size == 0 && s->size != 0))
+            sym_index[w] = symbol_count;
+        symbol_count++;
+    }
+    if (!check_duplicates())
+    {
+        printf("can not allocate symbols\n");
+        return 0;
+    }
+    /* spread each symbol over the words it covers */
+    for (i = 0; i < words; i++)
+    {
+        if (sym_index[i] >= 0)
+        {
+            const struct Symbol *s = &symbols[cur = sym_index[i]];
+            end = s->size ? (int)((s->addr + s->size - text_addr + 3) / 4) : words;
+        }
+        else if (i >= end)
+            cur = -1;
+        sym_index[i] = cur;
+    }
+    return 1;
+}
+
+/* symbol starting at the word, -1: none */
+int symbol_at(int i)
+{
+    int s = sym_index[i];
+    return s >= 0 && symbols[s].addr == text_addr + (uint64_t)i * 4 ? s : -1;
+}
+
+/* little endian and unaligned, as sections are placed at any offset */
+uint64_t read_le(const char *p, int size)
+{
+    uint64_t v = 0;
+    while (size > 0) v = v << 8 | (unsigned char)p[--size];
+    return v;
+}
+
+/* code and data: words are code when they are reached from the start
+   of the range, the entry point, a symbol, a value in a data section (a
+   pointer into .text or a switch table entry, which is 32 bits relative
+   to gp) or a function entry which nothing reaches, such as a function
+   called through a pointer or never called: a gp setup (ldah gp,x(t12);
+   lda gp,y(gp)) or a frame allocation (lda sp,-x(sp)) right after code.
+   Reaching follows fall through and branch targets and stops after br,
+   jmp and ret and at undefined words; the rest is data */
+
+#define GP_MAX 4
+
+int classify_words;
+int *classify_stack;
+
+/* marks the code reached from the word i */
+void reach(int i)
+{
+    int sp = 0;
+    if (i < 0 || !(leaders[i] & DATA)) return;
+    classify_stack[sp++] = i;
+    while (sp > 0)
+    {
+        for (i = classify_stack[--sp]; i < classify_words && (leaders[i] & DATA); i++)
+        {
+            const struct DecodedInsn *d = &insns[i];
+            enum Op op = opcodes[d->index];
+            if (d->index == 0) break;
+            leaders[i] &= ~DATA;
+            if (d->format == Bra)
+            {
+                int t = text_index(d->target);
+                if (t >= 0 && (leaders[t] & DATA)) classify_stack[sp++] = t;
+                if (op == Br) break;
+            }
+            else if (d->format == Mbr && (op == Jmp || op == Ret))
+                break;
+        }
+    }
+}
+
+int is_gp_setup(int i)
+{
+    const struct DecodedInsn *d = &insns[i];
+    return i + 1 < classify_words && opcodes[d->index] == Ldah && d->ra == GP && d->rb == T12
+        && opcodes[insns[i + 1].index] == Lda && insns[i + 1].ra == GP && insns[i + 1].rb == GP;
+}
+
+int classify_text(int words)
+{
+    uint64_t gps[GP_MAX];
+    int i, j, gp_count = 0;
+    /* every branch word pushes at most once */
+    classify_stack = (int *)realloc(classify_stack, (words + 1) * sizeof(int));
+    if (!classify_stack)
+    {
+        printf("can not allocate code map\n");
+        return 0;
+    }
+    classify_words = words;
+    memset(leaders, DATA, words);
+    reach(0);
+    for (i = 0; i < symbol_count; i++) reach(text_index(symbols[i].addr));
+    for (i = 0; i < words; i++)
+    {
+        uint64_t gp;
+        if (!is_gp_setup(i)) continue;
+        gp = text_addr + (uint64_t)i * 4 + (int64_t)insns[i].disp * 65536 + insns[i + 1].disp;
+        for (j = 0; j < gp_count && gps[j] != gp; j++);
+        if (j == gp_count && gp_count < GP_MAX) gps[gp_count++] = gp;
+    }
+    if (elf.ehdr)
+    {
+        reach(text_index(elf.ehdr->e_entry));
+        for (i = 0; i < elf.ehdr->e_shnum; i++)
+        {
+            const struct Elf64_Shdr *sh = &elf.shdrs[i];
+            const char *p;
+            uint64_t off;
+            if (!(sh->sh_flags & 2 /* SHF_ALLOC */) || (sh->sh_flags & 4 /* SHF_EXECINSTR */)
+                || sh->sh_type == 8 /* SHT_NOBITS */ || !(p = elf_contents(&elf, sh)))
+                continue;
+            for (off = (8 - sh->sh_addr) & 7; off + 8 <= sh->sh_size; off += 8)
+                reach(text_index(read_le(p + off, 8)));
+            for (off = (4 - sh->sh_addr) & 3; gp_count > 0 && off + 4 <= sh->sh_size; off += 4)
+            {
+                int64_t v = (int32_t)read_le(p + off, 4);
+                for (j = 0; j < gp_count; j++) reach(text_index(gps[j] + v));
+            }
+        }
+    }
+    for (i = 1; i < words; i++)
+    {
+        const struct DecodedInsn *d = &insns[i];
+        if ((leaders[i] & DATA) && (is_gp_setup(i) || (!(leaders[i - 1] & DATA)
+            && opcodes[d->index] == Lda && d->ra == SP && d->rb == SP && d->disp < 0)))
+            reach(i);
+    }
+    return 1;
+}
+
+/* output buffer: out_line_end() makes room for OUT_LINE more bytes */
+
+#define OUT_LINE 256
+
+struct Output
 {
-    UNDEF, Bis, Bis,
-    Addl, Ornot, Subl, Subl__v, Subq, Subq__v,
-    Cpys, Cpys, Cpys, Cpys, Cpysn,
-    Subf, Subf__s, Subg, Subg__s,
-    Subs, Subs__su, Subs__sui, Subt, Subt__su, Subt__sui
+    char *buf;
+    int len, size;
+    FILE *file;
+    void (*full)(struct Output *);
+    int comment;  /* the line has a comment */
 };
 
-const int poplen = sizeof(popnames) / sizeof(const char *);
+void out_flush(struct Output *o)
+{
+    if (o->len > 0) fwrite(o->buf, o->len, 1, o->file);
+    o->len = 0;
+}
 
-/* disassembler implementation */
+void out_grow(struct Output *o)
+{
+    char *buf = (char *)realloc(o->buf, o->size * 2);
+    if (!buf)
+    {
+        printf("can not allocate output\n");
+        exit(1);
+    }
+    o->buf = buf;
+    o->size *= 2;
+}
 
-void init_table()
+void out_line_end(struct Output *o)
 {
-    int i;
-    for (i = 0; i < oplen; i++)
+    o->comment = 0;
+    if (o->len > o->size - OUT_LINE) o->full(o);
+}
+
+void out_char(struct Output *o, int ch)
+{
+    o->buf[o->len++] = (char)ch;
+}
+
+void out_str(struct Output *o, const char *s)
+{
+    char *p = o->buf + o->len;
+    while (*s) *(p++) = *(s++);
+    o->len = (int)(p - o->buf);
+}
+
+/* starts the comment of the line, or continues the one it has, so a
+   line has at most one " ; " */
+void out_comment(struct Output *o)
+{
+    out_str(o, o->comment ? ", " : " ; ");
+    o->comment = 1;
+}
+
+/* any length: a file gets it directly, a buffer is grown as it fills */
+void out_mem(struct Output *o, const void *src, int len)
+{
+    const char *s = (const char *)src;
+    if (o->file)
     {
-        int op = (int)opcodes[i], h = op >> 16;
-        if (h != 0x18) subops[h][op & 0xffff] = opnames[i];
+        out_flush(o);
+        fwrite(s, len, 1, o->file);
+        return;
+    }
+    while (len > 0)
+    {
+        int n = o->size - o->len;
+        if (n == 0)
+        {
+            o->full(o);
+            continue;
+        }
+        if (n > len) n = len;
+        for (len -= n; n > 0; n--) o->buf[o->len++] = *(s++);
     }
 }
 
-enum Op get_op(uint32_t code)
+void out_hex(struct Output *o, uint64_t v, int w)
+{
+    char *p;
+    int n = 1;
+    while (n < 16 && (v >> (n * 4)) != 0) n++;
+    if (n < w) n = w;
+    o->len += n;
+    for (p = o->buf + o->len; n > 0; n--, v >>= 4)
+        *(--p) = "0123456789abcdef"[v & 15];
+}
+
+void out_dec(struct Output *o, int v)
+{
+    if (v >= 10) out_dec(o, v / 10);
+    out_char(o, '0' + v % 10);
+}
+
+void out_reg(struct Output *o, int r)
+{
+    out_str(o, regname[r]);
+}
+
+void out_freg(struct Output *o, int r)
+{
+    out_char(o, 'f');
+    out_dec(o, r);
+}
+
+void out_name(struct Output *o, const char *s)
+{
+    int i;
+    for (i = 0; i < NAME_MAX && s[i]; i++) out_char(o, s[i]);
+}
+
+void out_label(struct Output *o, uint64_t ad)
+{
+    out_char(o, 'L');
+    out_hex(o, ad, 8);
+}
+
+/* a symbol which can be a label is written by name, otherwise it is
+   put in a comment after the label or address */
+void out_target(struct Output *o, uint64_t ad)
 {
-    int op = (int)(code >> 26), subop = 0;
-    switch (op)
-    {
-    case 0x10:
-    case 0x11:
-    case 0x12:
-    case 0x13: subop = (code >> 5) & 0x7f; break;
-    case 0x14:
-    case 0x15:
-    case 0x16:
-    case 0x17: subop = (code >> 5) & 0x7ff; break;
-    case 0x18:
-        switch (code & 0xffff)
-        {
-        case 0x0000: return Trapb;
-        case 0x0400: return Excb;
-        case 0x4000: return Mb;
-        case 0x4400: return Wmb;
-        case 0x8000: return Fetch;
-        case 0xa000: return Fetch_m;
-        case 0xc000: return Rpcc;
-        case 0xe000: return Rc;
-        case 0xf000: return Rs;
-        case 0xe800: return Ecb;
-        case 0xf800: return Wh64;
-        case 0xfc00: return Wh64en;
-        default: return UNDEF;
+    int i = text_index(ad), s = i >= 0 ? sym_index[i] : -1;
+    const struct Symbol *sym = s >= 0 ? &symbols[s] : 0;
+    if (sym && sym->addr == ad && sym->label)
+    {
+        out_name(o, sym->name);
+        return;
+    }
+    if (is_label(ad))
+        out_label(o, ad);
+    else
+    {
+        out_str(o, "0x");
+        out_hex(o, ad, 8);
+    }
+    if (sym)
+    {
+        out_comment(o);
+        out_name(o, sym->name);
+        if (ad != sym->addr)
+        {
+            out_str(o, "+0x");
+            out_hex(o, ad - sym->addr, 0);
         }
-        break;
-    case 0x1a: subop = (code >> 14) & 3; break;
-    case 0x1c: subop = (code >> 5) & 0x7f; break;
     }
-    return subops[op][subop] ? (enum Op)((op << 16) | subop) : UNDEF;
 }
 
-const char *get_mnemonic(enum Op op)
+void out_mem_disp(struct Output *o, int disp, int rb)
 {
-    return op == UNDEF ? "UNDEF" : subops[((int)op) >>16][((int)op) & 0xffff];
+    if (0 <= disp && disp < 10)
+        out_dec(o, disp);
+    else if (disp >= 0)
+    {
+        out_str(o, "0x");
+        out_hex(o, disp, 0);
+    }
+    else
+    {
+        int disp2 = -disp;
+        if (disp2 < 10)
+        {
+            out_char(o, '-');
+            out_dec(o, disp2);
+        }
+        else
+        {
+            out_str(o, "-0x");
+            out_hex(o, disp2, 0);
+        }
+    }
+    if (rb != 31)
+    {
+        out_char(o, '(');
+        out_reg(o, rb);
+        out_char(o, ')');
+    }
 }
 
-enum Op disassemble(void *f, uint64_t addr, uint32_t code)
+enum Op format_insn(struct Output *o, const struct DecodedInsn *d)
 {
-    enum Op op = get_op(code);
-    int opc = (int)(code >> 26);
-    const char *mne = get_mnemonic(op);
-    switch (formats[opc])
+    enum Op op = opcodes[d->index];
+    const char *mne = opnames[d->index];
+    int ra = d->ra, rb = d->rb, rc = d->rc;
+    switch (d->format)
     {
     default:
         if (op == UNDEF)
-            fprintf(f, "opc%02x %08x", opc, code & 0x03ffffff);
+        {
+            out_str(o, "opc");
+            out_hex(o, d->opc, 2);
+        }
         else
-            fprintf(f, "%s %08x", mne, code & 0x03ffffff);
+            out_str(o, mne);
+        out_char(o, ' ');
+        out_hex(o, d->disp, 8);
         return op;
     case Bra:
         {
-            int ra = (int)((code >> 21) & 31);
-            int disp = code & 0x001fffff;
-            char sdisp[32];
-            if (disp < 0x00100000)
-                snprintf(sdisp, sizeof(sdisp), "%08x", addr + disp * 4 + 4);
-            else
-                snprintf(sdisp, sizeof(sdisp), "%08x", addr - (0x00200000 - disp) * 4 + 4);
             if (ra == 31 && op == Br)
-                fprintf(f, "br 0x%s", sdisp);
+                out_str(o, "br ");
             else
-                fprintf(f, "%s %s,0x%s", mne, regname[ra], sdisp);
+            {
+                out_str(o, mne);
+                out_char(o, ' ');
+                out_reg(o, ra);
+                out_char(o, ',');
+            }
+            out_target(o, d->target);
             return op;
         }
     case Mem:
         {
-            int ra = (int)((code >> 21) & 31);
-            int rb = (int)((code >> 16) & 31);
-            int disp = (int)(code & 0xffff);
-            char args[32];
-            if (disp < 10)
-                snprintf(args, sizeof(args), "%d", disp);
-            else if (disp < 0x8000)
-                snprintf(args, sizeof(args), "0x%x", disp);
-            else
-            {
-                int disp2 = 0x10000 - disp;
-                if (disp2 < 10)
-                    snprintf(args, sizeof(args), "-%d", disp2);
-                else
-                    snprintf(args, sizeof(args), "-0x%x", disp2);
-            }
-            if (rb != 31)
-            {
-                strncat(args, "(", sizeof(args));
-                strncat(args, regname[rb], sizeof(args));
-                strncat(args, ")", sizeof(args));
-            }
+            int disp = d->disp;
             if (op == Ldt || op == Stt)
             {
-                fprintf(f, "%s f%d,%s", mne, ra, args);
+                out_str(o, mne);
+                out_char(o, ' ');
+                out_freg(o, ra);
+                out_char(o, ',');
+                out_mem_disp(o, disp, rb);
                 return op;
             }
             else if (ra == 31)
             {
                 if (disp == 0 && op == Ldq_u)
                 {
-                    fprintf(f, "unop");
+                    out_str(o, "unop");
                     return op;
                 }
                 else
@@ -958,59 +828,62 @@ enum Op disassemble(void *f, uint64_t addr, uint32_t code)
                     }
                     if (pse)
                     {
-                        fprintf(f, "%s %s", pse, args);
+                        out_str(o, pse);
+                        out_char(o, ' ');
+                        out_mem_disp(o, disp, rb);
                         return op;
                     }
                 }
             }
-            fprintf(f, "%s %s,%s", mne, regname[ra], args);
+            out_str(o, mne);
+            out_char(o, ' ');
+            out_reg(o, ra);
+            out_char(o, ',');
+            out_mem_disp(o, disp, rb);
             return op;
         }
     case Mfc:
         {
-            int ra = (int)((code >> 21) & 31);
-            int rb = (int)((code >> 16) & 31);
-            fprintf(f, "%s %s,%s", mne, regname[ra], regname[rb]);
+            out_str(o, mne);
+            out_char(o, ' ');
+            out_reg(o, ra);
+            out_char(o, ',');
+            out_reg(o, rb);
             return op;
         }
     case Mbr:
         {
-            int ra = (int)((code >> 21) & 31);
-            int rb = (int)((code >> 16) & 31);
-            int hint = (int)(code & 0x3fff);
-            if (op == Ret && ra == Zero && rb == RA && hint == 1)
-                fprintf(f, "%s", mne);
-            else
-                fprintf(f, "%s %s,(%s),0x%04x", mne, regname[ra], regname[rb], hint);
+            int hint = d->disp;
+            out_str(o, mne);
+            if (!(op == Ret && ra == Zero && rb == RA && hint == 1))
+            {
+                out_char(o, ' ');
+                out_reg(o, ra);
+                out_str(o, ",(");
+                out_reg(o, rb);
+                out_str(o, "),0x");
+                out_hex(o, hint, 4);
+            }
             return op;
         }
     case Opr:
         {
-            int ra = (int)((code >> 21) & 31);
-            int rb = -1;
-            int rc = (int)(code & 31);
-            char arg2[32];
-            if ((code & 0x1000) == 0)
-            {
-                rb = (int)((code >> 16) & 31);
-                strncpy(arg2, regname[rb], sizeof(arg2));
-            }
-            else
-               snprintf(arg2, sizeof(arg2), "0x%02x", (code >> 13) & 0xff);
+            const char *pse = 0;
+            if (d->lit) rb = -1;
             if (ra == 31)
             {
-                const char *pse = 0;
                 switch (op)
                 {
                 case Bis:
                     if (rb == 31 && rc == 31)
                     {
-                        fprintf(f, "nop");
+                        out_str(o, "nop");
                         return op;
                     }
                     else if (rb == 31)
                     {
-                        fprintf(f, "clr %s", regname[rc]);
+                        out_str(o, "clr ");
+                        out_reg(o, rc);
                         return op;
                     }
                     else
@@ -1023,20 +896,33 @@ enum Op disassemble(void *f, uint64_t addr, uint32_t code)
                 case Subq: pse = "negq"; break;
                 case Subq__v: pse = "negq/v"; break;
                 }
-                if (pse)
-                {
-                    fprintf(f, "%s %s,%s", pse, arg2, regname[rc]);
-                    return op;
-                }
             }
-            fprintf(f, "%s %s,%s,%s", mne, regname[ra], arg2, regname[rc]);
+            if (pse)
+            {
+                out_str(o, pse);
+                out_char(o, ' ');
+            }
+            else
+            {
+                out_str(o, mne);
+                out_char(o, ' ');
+                out_reg(o, ra);
+                out_char(o, ',');
+            }
+            if (rb >= 0)
+                out_reg(o, rb);
+            else
+            {
+                out_str(o, "0x");
+                out_hex(o, d->disp, 2);
+            }
+            out_char(o, ',');
+            out_reg(o, rc);
             return op;
         }
     case F_P:
         {
-            int fa = (int)((code >> 21) & 31);
-            int fb = (int)((code >> 16) & 31);
-            int fc = (int)(code & 31);
+            int fa = ra, fb = rb, fc = rc;
             int pst = 2;
             const char *pse = 0;
             if (fa == 31)
@@ -1082,154 +968,2215 @@ enum Op disassemble(void *f, uint64_t addr, uint32_t code)
                     pse = mne;
                     break;
             }
-            if (pse)
-                switch (pst)
+            if (pse == 0)
             {
-                case 0:
-                    fprintf(f, "%s", pse);
-                    return op;
-                case 1:
-                    fprintf(f, "%s f%d", pse, fc);
-                    return op;
-                case 2:
-                    fprintf(f, "%s f%d,f%d", pse, fb, fc);
-                    return op;
+                pst = 3;
+                pse = mne;
+            }
+            out_str(o, pse);
+            if (pst == 0) return op;
+            out_char(o, ' ');
+            if (pst == 3)
+            {
+                out_freg(o, fa);
+                out_char(o, ',');
             }
-            fprintf(f, "%s f%d,f%d,f%d", mne, fa, fb, fc);
+            if (pst >= 2)
+            {
+                out_freg(o, fb);
+                out_char(o, ',');
+            }
+            out_freg(o, fc);
             return op;
         }
     }
-    return UNDEF;
+    return UNDEF;
+}
+
+/* --start, --end and --around: only this part of .text is decoded and
+   listed, and the rest of the image is never touched where it is mapped */
+uint64_t range_start, range_end = ~(uint64_t)0;
+
+/* narrows text_addr, text_size and text_buf to the range */
+void clip_text()
+{
+    uint64_t start = range_start, end = range_end, text_end = text_addr + text_size;
+    if (start < text_addr) start = text_addr;
+    if (end > text_end) end = text_end;
+    start -= (start - text_addr) & 3;
+    if (end < start) end = start;
+    text_buf += start - text_addr;
+    text_size = end - start;
+    text_addr = start;
+}
+
+/* finds .text in elf and makes room for its decode records */
+int load_text()
+{
+    const struct Elf64_Shdr *sh;
+    if (elf.ehdr->e_machine != 0x9026)
+    {
+        printf("e_machine != EM_ALPHA_EXP\n");
+        return 0;
+    }
+    if (!(sh = elf_section(&elf, ".text")) || !(text_buf = elf_contents(&elf, sh)))
+    {
+        printf("can not read .text section\n");
+        return 0;
+    }
+    text_addr = sh->sh_addr;
+    text_size = sh->sh_size;
+    text_shndx = (int)(sh - elf.shdrs);
+    clip_text();
+    insns = (struct DecodedInsn *)realloc(insns, (text_size / 4 + 1) * sizeof(struct DecodedInsn));
+    if (!insns)
+    {
+        printf("can not allocate decode records\n");
+        return 0;
+    }
+    return 1;
+}
+
+int read_text(const char *fn)
+{
+    elf_close(&elf);
+    return elf_open(&elf, fn) && load_text();
+}
+
+/* functions end at a symbol and after each ret */
+int function_end(int start, int words)
+{
+    int i;
+    for (i = start + 1; i < words && symbol_at(i) < 0
+        && ((leaders[i - 1] & DATA) || opcodes[insns[i - 1].index] != Ret); i++);
+    return i;
+}
+
+/* references: the calls, jumps and gp-relative data references of
+   .text. Register values are followed through each block: gp from the
+   ldah/lda pair which sets it up, addresses from lda and ldah, and
+   values loaded by ldq from the file, such as .got entries and the
+   pointers in .sdata they point to, so a jsr through t12 gets its
+   target. There is at most one reference per word, in source order */
+
+#define XREF_CALL 1
+#define XREF_JUMP 2
+#define XREF_DATA 3
+
+struct XrefEdge
+{
+    uint64_t from, to;             /* the kind is in the low 2 bits of from */
+};
+
+const char *xref_kinds[] =
+{
+    "", "call", "jump", "data"
+};
+
+struct XrefEdge *xrefs;
+int xref_count, xref_size;
+
+int add_xref(int i, uint64_t to, int kind)
+{
+    if (xref_count == xref_size)
+    {
+        xref_size = xref_size ? xref_size * 2 : 1024;
+        if (!(xrefs = (struct XrefEdge *)realloc(xrefs, xref_size * sizeof(struct XrefEdge))))
+        {
+            printf("can not allocate cross references\n");
+            xref_count = xref_size = 0;
+            return 0;
+        }
+    }
+    xrefs[xref_count].from = (text_addr + (uint64_t)i * 4) | kind;
+    xrefs[xref_count++].to = to;
+    return 1;
+}
+
+int is_store(int opc)
+{
+    return (opc >= 0x0d && opc <= 0x0f) || (opc >= 0x24 && opc <= 0x27) || opc >= 0x2c;
+}
+
+int build_xref(int words)
+{
+    uint64_t value[32];
+    uint32_t known = 0;  /* bit r: value[r] holds r */
+    int i, end = 0;
+    xref_count = 0;
+    for (i = 0; i < words; i++)
+    {
+        const struct DecodedInsn *d = &insns[i];
+        enum Op op = opcodes[d->index];
+        uint64_t v = 0, ea;
+        const char *p;
+        int dst = -1, ok = 0, kind = 0;
+        if (i == end)
+        {
+            end = function_end(i, words);
+            known = 0;
+        }
+        else if (leaders[i] & LEADER)
+            known &= 1u << GP;  /* gp holds in a function, the rest in a block */
+        if (leaders[i] & DATA) continue;
+        switch (d->format)
+        {
+        case Bra:
+            kind = op == Bsr ? XREF_CALL : op == Br ? XREF_JUMP : 0;
+            if (kind)
+            {
+                if (!add_xref(i, d->target, kind)) return 0;
+                dst = d->ra;
+            }
+            break;
+        case Mbr:
+            kind = op == Jsr ? XREF_CALL : op == Jmp ? XREF_JUMP : 0;
+            if (kind && (known >> d->rb & 1) && !add_xref(i, value[d->rb], kind)) return 0;
+            dst = d->ra;
+            break;
+        case Mem:
+            if (d->ra == GP && op == Ldah && (d->rb == T12 || d->rb == RA))
+            {
+                /* gp setup, at the entry or after a call returning here */
+                v = text_addr + (uint64_t)i * 4 + (int64_t)d->disp * 65536;
+                ok = 1;
+            }
+            else if (known >> d->rb & 1)
+            {
+                ea = value[d->rb] + (op == Ldah ? (int64_t)d->disp * 65536 : (int64_t)d->disp);
+                if (op == Lda || op == Ldah)
+                {
+                    v = ea;
+                    ok = 1;
+                }
+                else if ((op == Ldq || op == Ldl) && (p = elf_address(&elf, ea, op == Ldq ? 8 : 4)) != 0)
+                {
+                    v = op == Ldq ? read_le(p, 8) : (uint64_t)(int64_t)(int32_t)read_le(p, 4);
+                    ok = 1;
+                }
+                if (!(d->ra == GP && d->rb == GP) && !add_xref(i, ea, XREF_DATA)) return 0;
+            }
+            if (d->opc < 0x20 || d->opc > 0x27)
+                dst = is_store(d->opc) && d->opc != 0x2e && d->opc != 0x2f ? -1 : d->ra;
+            break;
+        case Opr:
+            /* mov: bis zero,rb,rc */
+            if (op == Bis && d->ra == 31 && !d->lit && (known >> d->rb & 1))
+            {
+                v = value[d->rb];
+                ok = 1;
+            }
+            dst = d->rc;
+            break;
+        case Mfc:
+            if (op == Rpcc) dst = d->ra;
+            break;
+        }
+        if (dst >= 0 && dst != 31)
+        {
+            if (ok)
+            {
+                value[dst] = v;
+                known |= 1u << dst;
+            }
+            else
+                known &= ~(1u << dst);
+        }
+    }
+    return 1;
+}
+
+char out_buf[65536];
+int jobs = 1;     /* -j: listings are serial unless it is given */
+int jobs_given;   /* --sweep and --check-jobs default to online_cpus() */
+
+/* decodes .text into insns, indexes its symbols, recovers its code and
+   control flow graph and resolves its references */
+int analyze_text()
+{
+    int words = (int)(text_size / 4);
+    decode_text(insns, text_addr, text_buf, words);
+    return load_symbols(words) && build_cfg(words) && build_xref(words);
+}
+
+#define DATA_LINE 4
+
+/* up to DATA_LINE values of the data run at .text[j], .quad when it is
+   aligned and .long otherwise; a run ends at a symbol or a label.
+   Returns the bytes written */
+int format_data(struct Output *o, int j, int end)
+{
+    int i = j / 4, n, k;
+    for (n = 1; n < DATA_LINE * 2 && j + n * 4 < end && (leaders[i + n] & DATA)
+        && !(leaders[i + n] & TARGET) && symbol_at(i + n) < 0; n++);
+    if (((text_addr + j) & 7) == 0 && n >= 2)
+    {
+        out_str(o, ".quad ");
+        for (k = 0; k + 2 <= n; k += 2)
+        {
+            if (k > 0) out_str(o, ", ");
+            out_str(o, "0x");
+            out_hex(o, (uint64_t)insns[i + k + 1].code << 32 | insns[i + k].code, 16);
+        }
+        n = k;
+    }
+    else
+    {
+        out_str(o, ".long 0x");
+        out_hex(o, insns[i].code, 8);
+        n = 1;
+    }
+    out_char(o, '\n');
+    out_line_end(o);
+    return n * 4;
+}
+
+/* the host services our programs call through the pointers at
+   HOST_BASE, in the order of their declarations */
+
+#define HOST_BASE 0x00ef0000
+
+const char *host_names[] =
+{
+    "exit", "fputc", "fgetc", "fopen", "fclose", "fwrite", "fread", "fseek"
+};
+
+const int host_count = sizeof(host_names) / sizeof(const char *);
+
+int host_index(uint64_t ad)
+{
+    uint64_t off = ad - HOST_BASE;
+    return off < (uint64_t)host_count * 4 && (off & 3) == 0 ? (int)(off / 4) : -1;
+}
+
+/* the first reference from ad or later */
+int find_xref(uint64_t ad)
+{
+    int lo = 0, hi = xref_count;
+    while (lo < hi)
+    {
+        int mid = (lo + hi) / 2;
+        if ((xrefs[mid].from & ~(uint64_t)3) < ad) lo = mid + 1; else hi = mid;
+    }
+    return lo;
+}
+
+/* a host service, a symbol of .text, a section and offset or hex */
+void out_address(struct Output *o, uint64_t ad)
+{
+    int h = host_index(ad), i = text_index(ad), k;
+    if (h >= 0)
+    {
+        out_str(o, host_names[h]);
+        return;
+    }
+    if (i >= 0 && sym_index[i] >= 0)
+    {
+        const struct Symbol *sym = &symbols[sym_index[i]];
+        out_name(o, sym->name);
+        if (ad != sym->addr)
+        {
+            out_str(o, "+0x");
+            out_hex(o, ad - sym->addr, 0);
+        }
+        return;
+    }
+    for (k = 0; elf.ehdr && k < elf.ehdr->e_shnum; k++)
+    {
+        const struct Elf64_Shdr *sh = &elf.shdrs[k];
+        if ((sh->sh_flags & 2 /* SHF_ALLOC */) && ad - sh->sh_addr < sh->sh_size
+            && sh->sh_name < elf.shstrsize)
+        {
+            out_name(o, elf.shstrtab + sh->sh_name);
+            out_str(o, "+0x");
+            out_hex(o, ad - sh->sh_addr, 0);
+            return;
+        }
+    }
+    out_str(o, "0x");
+    out_hex(o, ad, 8);
+}
+
+void print_host_calls()
+{
+    int i, calls[sizeof(host_names) / sizeof(const char *)], total = 0;
+    memset(calls, 0, sizeof(calls));
+    for (i = 0; i < xref_count; i++)
+    {
+        int h = host_index(xrefs[i].to);
+        if ((xrefs[i].from & 3) == XREF_CALL && h >= 0)
+        {
+            calls[h]++;
+            total++;
+        }
+    }
+    if (total == 0) return;
+    printf("host calls: %d", total);
+    for (i = 0; i < host_count; i++)
+        if (calls[i]) printf(", %s %d", host_names[i], calls[i]);
+    printf("\n");
+}
+
+/* formats .text[start, end) from insns, with a line for each symbol, a
+   label line before each branch target which has no symbol label and
+   the resolved targets of jumps and gp-relative accesses in comments */
+void format_text(struct Output *o, int start, int end)
+{
+    int j, r = find_xref(text_addr + start);
+    for (j = start; j < end; j += 4)
+    {
+        enum Op op;
+        int s = symbol_at(j / 4);
+        if (s >= 0)
+        {
+            out_str(o, "0x");
+            out_hex(o, text_addr + j, 8);
+            if (symbols[s].label)
+            {
+                out_str(o, ": ");
+                out_name(o, symbols[s].name);
+                out_str(o, ":\n");
+            }
+            else
+            {
+                out_char(o, ':');
+                out_comment(o);
+                out_name(o, symbols[s].name);
+                out_char(o, '\n');
+            }
+            out_line_end(o);
+        }
+        else if (j == 0 && sym_index[0] >= 0)
+        {
+            /* a range starting inside a function */
+            const struct Symbol *sym = &symbols[sym_index[0]];
+            out_str(o, "0x");
+            out_hex(o, text_addr, 8);
+            out_char(o, ':');
+            out_comment(o);
+            out_name(o, sym->name);
+            out_str(o, "+0x");
+            out_hex(o, text_addr - sym->addr, 0);
+            out_char(o, '\n');
+            out_line_end(o);
+        }
+        if ((leaders[j / 4] & TARGET) && !(s >= 0 && symbols[s].label))
+        {
+            out_str(o, "0x");
+            out_hex(o, text_addr + j, 8);
+            out_str(o, ": ");
+            out_label(o, text_addr + j);
+            out_str(o, ":\n");
+        }
+        out_str(o, "0x");
+        out_hex(o, text_addr + j, 8);
+        out_str(o, ": ");
+        if (leaders[j / 4] & DATA)
+        {
+            j += format_data(o, j, end) - 4;
+            continue;
+        }
+        op = format_insn(o, &insns[j / 4]);
+        while (r < xref_count && (xrefs[r].from & ~(uint64_t)3) < text_addr + j) r++;
+        if (r < xref_count && (xrefs[r].from & ~(uint64_t)3) == text_addr + j && insns[j / 4].format != Bra)
+        {
+            out_comment(o);
+            out_address(o, xrefs[r].to);
+        }
+        out_char(o, '\n');
+        if (op == Ret) out_char(o, '\n');
+        out_line_end(o);
+    }
+}
+
+/* function cache (-c): .text is split into functions at symbols and
+   after each ret, and the listing of each function is kept in
+   <listing>.cache under a hash of everything it is formatted from, so
+   an unchanged function is copied instead of formatted. A record is the
+   key, the length and the text padded to 8 bytes */
+
+#define FUNC_MAGIC "7dcache1"
+
+struct FuncEntry
+{
+    uint64_t key;
+    int offset, len;
+};
+
+int use_cache;
+struct Elf func_file;  /* the previous cache, elf_load() maps any file */
+struct FuncEntry *func_entries;
+int func_count, func_mask, *func_slots;
+
+uint64_t hash_word(uint64_t h, uint64_t v)
+{
+    return (h ^ v) * 0x100000001b3ull;
+}
+
+uint64_t hash_str(uint64_t h, const char *s)
+{
+    for (; *s; s++) h = (h ^ (unsigned char)*s) * 0x100000001b3ull;
+    return h;
+}
+
+uint64_t hash_symbol(uint64_t h, int s)
+{
+    if (s < 0) return hash_word(h, 0);
+    h = hash_str(h, symbols[s].name);
+    return hash_word(hash_word(h, symbols[s].addr), symbols[s].label);
+}
+
+/* everything format_text() reads for the words [start, end) */
+uint64_t func_key(int start, int end)
+{
+    uint64_t h = hash_word(0xcbf29ce484222325ull, text_addr + (uint64_t)start * 4);
+    int i, r;
+    if (start == 0) h = hash_symbol(h, sym_index[0]);
+    for (i = start; i < end; i++)
+    {
+        const struct DecodedInsn *d = &insns[i];
+        h = hash_word(h, d->code | (uint64_t)(leaders[i] & (TARGET | DATA)) << 32);
+        h = hash_symbol(h, symbol_at(i));
+        if (d->format == Bra)
+        {
+            int t = text_index(d->target);
+            h = hash_word(h, is_label(d->target));
+            h = hash_symbol(h, t >= 0 ? sym_index[t] : -1);
+        }
+    }
+    for (r = find_xref(text_addr + (uint64_t)start * 4);
+        r < xref_count && (xrefs[r].from & ~(uint64_t)3) < text_addr + (uint64_t)end * 4; r++)
+    {
+        int t = text_index(xrefs[r].to);
+        h = hash_word(hash_word(h, xrefs[r].from), xrefs[r].to);
+        h = hash_symbol(h, t >= 0 ? sym_index[t] : -1);
+    }
+    return h;
+}
+
+void load_func_cache(const char *fn)
+{
+    int off = 8, i;
+    func_count = 0;
+    elf_close(&func_file);
+    if (!elf_load(&func_file, fn) || func_file.size < 8 || func_file.size > 0x7fffffff) return;
+    for (i = 0; i < 8 && func_file.data[i] == FUNC_MAGIC[i]; i++);
+    if (i < 8) return;
+    while (off + 16 <= (int)func_file.size)
+    {
+        uint64_t key = *(const uint64_t *)(func_file.data + off);
+        int len = *(const int *)(func_file.data + off + 8);
+        if (len < 0 || len > (int)func_file.size - off - 16) break;
+        if ((func_count & (func_count - 1)) == 0)
+        {
+            func_entries = (struct FuncEntry *)realloc(func_entries, (func_count * 2 + 1) * sizeof(struct FuncEntry));
+            if (!func_entries)
+            {
+                func_count = 0;
+                return;
+            }
+        }
+        func_entries[func_count].key = key;
+        func_entries[func_count].offset = off + 16;
+        func_entries[func_count].len = len;
+        func_count++;
+        off += 16 + ((len + 7) & ~7);
+    }
+    for (func_mask = 1; func_mask < func_count * 2; func_mask <<= 1);
+    if (!(func_slots = (int *)realloc(func_slots, func_mask * sizeof(int))))
+    {
+        func_count = 0;
+        return;
+    }
+    memset(func_slots, -1, func_mask * sizeof(int));
+    func_mask--;
+    for (i = 0; i < func_count; i++)
+    {
+        int h = (int)func_entries[i].key & func_mask;
+        while (func_slots[h] >= 0) h = (h + 1) & func_mask;
+        func_slots[h] = i;
+    }
+}
+
+const struct FuncEntry *find_func(uint64_t key)
+{
+    int h;
+    if (func_count == 0) return 0;
+    for (h = (int)key & func_mask; func_slots[h] >= 0; h = (h + 1) & func_mask)
+        if (func_entries[func_slots[h]].key == key) return &func_entries[func_slots[h]];
+    return 0;
+}
+
+void write_func_cache(const char *fn, const struct FuncEntry *list, int count, const char *buf)
+{
+    static const char pad[8];
+    FILE *f;
+    int i;
+#if defined(__alpha) || defined(_MSC_VER)
+    /* the previous cache was read into memory */
+    elf_close(&func_file);
+    f = fopen(fn, "wb");
+#else
+    /* the previous cache is mapped, so it is replaced only when done */
+    char tmp[256];
+    snprintf(tmp, sizeof(tmp), "%s.new", fn);
+    f = fopen(tmp, "wb");
+#endif
+    if (!f) return;
+    fwrite(FUNC_MAGIC, 8, 1, f);
+    for (i = 0; i < count; i++)
+    {
+        const struct FuncEntry *e = &list[i];
+        int len = e->len;
+        fwrite(&e->key, 8, 1, f);
+        fwrite(&len, 4, 1, f);
+        fwrite(pad, 4, 1, f);
+        if (len > 0) fwrite(e->offset < 0 ? func_file.data - e->offset - 1 : buf + e->offset, len, 1, f);
+        fwrite(pad, (8 - (len & 7)) & 7, 1, f);
+    }
+    fclose(f);
+#if !defined(__alpha) && !defined(_MSC_VER)
+    elf_close(&func_file);
+    rename(tmp, fn);
+#endif
+}
+
+/* hits are copied from the previous cache, misses are formatted into a
+   buffer; the cache is rewritten only if anything was formatted */
+void format_cached(struct Output *o, const char *dst)
+{
+    char fn[256];
+    struct Output c;
+    struct FuncEntry *list = 0;
+    int i, start, funcs = 0, hits = 0;
+    int64_t hit_words = 0, miss_words = 0;
+    long miss_time = 0;
+    int words = (int)(text_size / 4);
+    snprintf(fn, sizeof(fn), "%s.cache", dst);
+    load_func_cache(fn);
+    c.size = 65536;
+    c.buf = (char *)malloc(c.size);
+    c.len = 0;
+    c.file = 0;
+    c.full = out_grow;
+    c.comment = 0;
+    for (start = 0; start < words; start = i)
+    {
+        const struct FuncEntry *e;
+        struct FuncEntry *fe;
+        i = function_end(start, words);
+        if ((funcs & (funcs - 1)) == 0)
+        {
+            list = (struct FuncEntry *)realloc(list, (funcs * 2 + 1) * sizeof(struct FuncEntry));
+            if (!list)
+            {
+                printf("can not allocate function cache\n");
+                free(c.buf);
+                return;
+            }
+        }
+        fe = &list[funcs++];
+        fe->key = func_key(start, i);
+        if ((e = find_func(fe->key)) != 0)
+        {
+            /* offset < 0: -1 - offset in the previous cache */
+            fe->offset = -1 - e->offset;
+            fe->len = e->len;
+            out_mem(o, func_file.data + e->offset, e->len);
+            hits++;
+            hit_words += i - start;
+        }
+        else
+        {
+            long t = clock();
+            fe->offset = c.len;
+            format_text(&c, start * 4, i * 4);
+            fe->len = c.len - fe->offset;
+            miss_time += clock() - t;
+            miss_words += i - start;
+            out_mem(o, c.buf + fe->offset, fe->len);
+        }
+    }
+    if (hits < funcs || funcs != func_count) write_func_cache(fn, list, funcs, c.buf);
+    free(list);
+    free(c.buf);
+    printf("cache: %d/%d functions hit (%d%%)", hits, funcs, funcs ? hits * 100 / funcs : 0);
+    if (miss_words > 0 && miss_time > 0)
+        printf(", %d ms saved", (int)(hit_words * miss_time / miss_words * 1000 / CLOCKS_PER_SEC));
+    printf("\n");
+}
+
+/* binary listing (-r): a header, one fixed size record per word and the
+   mnemonics as offsets into a string table, all little endian and
+   aligned, so a reader maps the file and uses it in place. version is
+   raised whenever the layout changes */
+
+#define BIN_VERSION 1
+
+struct BinHeader
+{
+    char magic[4];                 /* "7db" */
+    uint32_t version;
+    uint64_t text_addr;
+    uint32_t count, record_size;   /* records */
+    uint32_t records, names;       /* file offsets of records and name offsets */
+    uint32_t name_count, strings;  /* mnemonics, file offset of their strings */
+};
+
+struct BinInsn
+{
+    uint64_t addr, target;         /* target: Bra destination */
+    uint32_t code;
+    int32_t disp;                  /* as in DecodedInsn */
+    uint16_t op;                   /* opnames index, 0: undefined */
+    unsigned char format, ra, rb, rc, lit;
+    unsigned char flags;           /* LEADER, TARGET, DATA */
+};
+
+int binary_mode;
+
+void write_binary(FILE *f)
+{
+    struct BinHeader h;
+    struct BinInsn *r = (struct BinInsn *)out_buf;
+    int i, n, count = (int)(text_size / 4), per_buf = sizeof(out_buf) / sizeof(struct BinInsn);
+    uint32_t off;
+    memset(&h, 0, sizeof(h));
+    h.magic[0] = '7';
+    h.magic[1] = 'd';
+    h.magic[2] = 'b';
+    h.version = BIN_VERSION;
+    h.text_addr = text_addr;
+    h.count = count;
+    h.record_size = sizeof(struct BinInsn);
+    h.records = sizeof(struct BinHeader);
+    h.names = h.records + count * sizeof(struct BinInsn);
+    h.name_count = oplen;
+    h.strings = h.names + oplen * 4;
+    fwrite(&h, sizeof(h), 1, f);
+    for (i = 0; i < count; i += n)
+    {
+        int j;
+        n = count - i < per_buf ? count - i : per_buf;
+        for (j = 0; j < n; j++)
+        {
+            const struct DecodedInsn *d = &insns[i + j];
+            struct BinInsn *b = &r[j];
+            b->addr = text_addr + (uint64_t)(i + j) * 4;
+            b->target = d->target;
+            b->code = d->code;
+            b->disp = d->disp;
+            b->op = (uint16_t)d->index;
+            b->format = d->format;
+            b->ra = d->ra;
+            b->rb = d->rb;
+            b->rc = d->rc;
+            b->lit = d->lit;
+            b->flags = leaders[i + j];
+        }
+        fwrite(r, sizeof(struct BinInsn), n, f);
+    }
+    for (i = 0, off = 0; i < oplen; i++)
+    {
+        fwrite(&off, 4, 1, f);
+        off += strlen(opnames[i]) + 1;
+    }
+    for (i = 0; i < oplen; i++) fwrite(opnames[i], strlen(opnames[i]) + 1, 1, f);
+}
+
+/* EV5 pipeline model (-p): a static estimate of the cycles of each
+   block on a 21164. The instructions of an aligned octaword issue in
+   order, up to one per pipe (E0 and E1 integer, FA and FM floating
+   point) in a cycle, once their operands are ready and the multiplier
+   or divider is free; the next octaword starts after the last one has
+   issued. Loads are assumed to hit the D-cache, branches to be
+   predicted and each block to start with all registers ready, so a
+   block costs the cycle of its last issue plus one. The latencies are
+   those of the 21164 hardware reference manual */
+
+#define E0 1
+#define E1 2
+#define FA 4
+#define FM 8
+
+#define STALL_SITES 10
+
+struct PipeClass
+{
+    int pipes, latency;
+    int unit, busy;  /* 1: multiplier, 2: divider; cycles until the next one */
+    int src[3], dst; /* 0-31 integer, 32-63 FP registers, -1: none */
+};
+
+struct StallSite
+{
+    int index, cycles, reg, from;  /* from: the producer, -1: a busy unit */
+};
+
+int pipe_mode;
+struct StallSite stall_sites[STALL_SITES];
+int stall_count;
+
+void pipe_class(struct PipeClass *c, const struct DecodedInsn *d)
+{
+    enum Op op = opcodes[d->index];
+    int fnc = (int)((d->code >> 5) & (d->format == Opr ? 0x7f : 0x7ff));
+    c->pipes = E0 | E1;
+    c->latency = 1;
+    c->unit = c->busy = 0;
+    c->src[0] = c->src[1] = c->src[2] = c->dst = -1;
+    switch (d->format)
+    {
+    case Mem:
+        c->src[0] = d->rb;
+        if (d->opc == 0x08 || d->opc == 0x09)
+            c->dst = d->ra;
+        else if (d->opc >= 0x20 && d->opc <= 0x23)
+        {
+            c->dst = 32 + d->ra;
+            c->latency = 3;
+        }
+        else if (d->opc >= 0x24 && d->opc <= 0x27)
+        {
+            c->pipes = E0;
+            c->src[1] = 32 + d->ra;
+        }
+        else if (d->opc == 0x0d || d->opc == 0x0e || d->opc == 0x0f || d->opc >= 0x2c)
+        {
+            c->pipes = E0;
+            c->src[1] = d->ra;
+            if (d->opc == 0x2e || d->opc == 0x2f) c->dst = d->ra;
+        }
+        else
+        {
+            c->dst = d->ra;
+            c->latency = 2;
+        }
+        break;
+    case Bra:
+        if (d->opc == 0x30 || d->opc == 0x34)
+        {
+            c->pipes = E1;
+            c->dst = d->ra;
+        }
+        else if ((d->opc & 3) != 0 && d->opc < 0x38)
+        {
+            c->pipes = FA;
+            c->src[0] = 32 + d->ra;
+        }
+        else
+        {
+            c->pipes = E1;
+            c->src[0] = d->ra;
+        }
+        break;
+    case Mbr:
+        c->pipes = E1;
+        c->src[0] = d->rb;
+        c->dst = d->ra;
+        break;
+    case Opr:
+        c->src[0] = d->opc == 0x1c && (op == Ftoit || op == Ftois) ? 32 + d->ra : d->ra;
+        if (!d->lit) c->src[1] = d->rb;
+        c->dst = d->rc;
+        if (op == Cmoveq || op == Cmovne || op == Cmovlt || op == Cmovge ||
+            op == Cmovle || op == Cmovgt || op == Cmovlbs || op == Cmovlbc)
+        {
+            /* rc keeps its value when the move is not taken */
+            c->src[2] = d->rc;
+            c->latency = 2;
+        }
+        else if (d->opc == 0x12 || d->opc == 0x1c)
+            c->pipes = E0;
+        else if (d->opc == 0x13)
+        {
+            /* mull, mulq, umulh */
+            int kind = (fnc >> 4) & 3;
+            c->pipes = E0;
+            c->unit = 1;
+            c->latency = kind == 0 ? 8 : kind == 2 ? 12 : 14;
+            c->busy = kind == 0 ? 4 : 8;
+        }
+        break;
+    case F_P:
+        c->src[0] = 32 + d->ra;
+        c->src[1] = 32 + d->rb;
+        c->dst = 32 + d->rc;
+        c->pipes = FA;
+        c->latency = 4;
+        if (op == Itofs || op == Itoff || op == Itoft)
+            c->src[0] = d->ra;
+        else if (d->opc == 0x14)
+        {
+            /* square roots run in the divider */
+            c->src[0] = -1;
+            c->unit = 2;
+            c->latency = c->busy = fnc & 0x20 ? 22 : 15;
+        }
+        else if (d->opc == 0x17 && fnc >= 0x20 && fnc <= 0x22)
+            c->pipes = FA | FM;
+        else if (d->opc != 0x17 && (fnc & 0x0f) == 2)
+            c->pipes = FM;
+        else if (d->opc != 0x17 && (fnc & 0x0f) == 3)
+        {
+            c->unit = 2;
+            c->latency = c->busy = fnc & 0x20 ? 22 : 15;
+        }
+        break;
+    case Mfc:
+        c->pipes = E0;
+        if (op == Rpcc) c->dst = d->ra;
+        break;
+    default:
+        c->pipes = E0;
+        break;
+    }
+    if (c->dst == 31 || c->dst == 63) c->dst = -1;
+}
+
+/* keeps the STALL_SITES longest stalls */
+void add_stall(int index, int cycles, int reg, int from)
+{
+    int i = stall_count < STALL_SITES ? stall_count++ : STALL_SITES - 1;
+    if (i == STALL_SITES - 1 && stall_sites[i].cycles >= cycles) return;
+    for (; i > 0 && stall_sites[i - 1].cycles < cycles; i--) stall_sites[i] = stall_sites[i - 1];
+    stall_sites[i].index = index;
+    stall_sites[i].cycles = cycles;
+    stall_sites[i].reg = reg;
+    stall_sites[i].from = from;
+}
+
+/* the cycles of the words [start, end) issued from an empty pipeline,
+   adding its stalls to stall_sites if record is set */
+int model_block(int start, int end, int record)
+{
+    int ready[64], producer[64], unit_free[3] = {0, 0, 0};
+    int i, cycle = 0, used = 0;
+    uint64_t group = ((text_addr >> 2) + start) & ~(uint64_t)3;
+    memset(ready, 0, sizeof(ready));
+    for (i = start; i < end; i++)
+    {
+        struct PipeClass c;
+        int k, need = cycle, reg = -1, p;
+        pipe_class(&c, &insns[i]);
+        if ((((text_addr >> 2) + i) & ~(uint64_t)3) != group)
+        {
+            /* the next octaword issues after the previous one; octawords
+               follow the addresses, text_addr need not be 16-aligned */
+            group = ((text_addr >> 2) + i) & ~(uint64_t)3;
+            if (used) cycle++;
+            used = 0;
+            need = cycle;
+        }
+        for (k = 0; k < 3; k++)
+        {
+            int r = c.src[k];
+            if (r >= 0 && r != 31 && r != 63 && ready[r] > need)
+            {
+                need = ready[r];
+                reg = r;
+            }
+        }
+        if (c.unit && unit_free[c.unit] > need)
+        {
+            need = unit_free[c.unit];
+            reg = -1;
+        }
+        if (need > cycle)
+        {
+            if (record) add_stall(i, need - cycle, reg, reg >= 0 ? producer[reg] : -1);
+            cycle = need;
+            used = 0;
+        }
+        if (!(p = c.pipes & ~used))
+        {
+            cycle++;
+            used = 0;
+            p = c.pipes;
+        }
+        used |= p & -p;
+        if (c.dst >= 0)
+        {
+            ready[c.dst] = cycle + c.latency;
+            producer[c.dst] = i;
+        }
+        if (c.unit) unit_free[c.unit] = cycle + c.busy;
+    }
+    return end > start ? cycle + 1 : 0;
+}
+
+void out_ratio(struct Output *o, int64_t a, int64_t b)
+{
+    int v = b ? (int)(a * 100 / b) : 0;
+    out_dec(o, v / 100);
+    out_char(o, '.');
+    out_char(o, '0' + v / 10 % 10);
+    out_char(o, '0' + v % 10);
+}
+
+void out_where(struct Output *o, int i)
+{
+    out_str(o, "0x");
+    out_hex(o, text_addr + (uint64_t)i * 4, 8);
+    if (sym_index[i] >= 0)
+    {
+        const struct Symbol *sym = &symbols[sym_index[i]];
+        out_str(o, " ");
+        out_name(o, sym->name);
+        out_str(o, "+0x");
+        out_hex(o, text_addr + (uint64_t)i * 4 - sym->addr, 0);
+    }
+}
+
+/* a line for each function and its blocks, then the longest stalls */
+void write_pipeline(struct Output *o)
+{
+    int words = (int)(text_size / 4), start, end, b, e, i, funcs = 0;
+    int64_t total = 0;
+    stall_count = 0;
+    for (start = 0; start < words; start = end)
+    {
+        int s = sym_index[start], blocks = 0, cycles = 0;
+        end = function_end(start, words);
+        for (b = start; b < end; b = e)
+        {
+            for (e = b + 1; e < end && !(leaders[e] & LEADER); e++);
+            if (leaders[b] & DATA) continue;
+            cycles += model_block(b, e, 1);
+            blocks++;
+        }
+        out_str(o, "0x");
+        out_hex(o, text_addr + (uint64_t)start * 4, 8);
+        out_str(o, ": ");
+        if (s >= 0 && symbols[s].addr == text_addr + (uint64_t)start * 4)
+            out_name(o, symbols[s].name);
+        else
+            out_str(o, "(no symbol)");
+        out_str(o, ": ");
+        out_dec(o, end - start);
+        out_str(o, " insns, ");
+        out_dec(o, blocks);
+        out_str(o, " blocks, ");
+        out_dec(o, cycles);
+        out_str(o, " cycles, ipc ");
+        out_ratio(o, end - start, cycles);
+        out_char(o, '\n');
+        out_line_end(o);
+        for (b = start; b < end; b = e)
+        {
+            int t;
+            for (e = b + 1; e < end && !(leaders[e] & LEADER); e++);
+            if (leaders[b] & DATA) continue;
+            out_str(o, "  0x");
+            out_hex(o, text_addr + (uint64_t)b * 4, 8);
+            out_str(o, ": ");
+            out_dec(o, e - b);
+            out_str(o, " insns, ");
+            out_dec(o, model_block(b, e, 0));
+            out_str(o, " cycles");
+            if (insns[e - 1].format == Bra && (t = text_index(insns[e - 1].target)) >= start && t <= b)
+                out_str(o, ", loop");
+            out_char(o, '\n');
+            out_line_end(o);
+        }
+        funcs++;
+        total += cycles;
+    }
+    out_str(o, "\nworst stalls:\n");
+    for (i = 0; i < stall_count; i++)
+    {
+        const struct StallSite *st = &stall_sites[i];
+        out_where(o, st->index);
+        out_str(o, ": ");
+        format_insn(o, &insns[st->index]);
+        out_comment(o);
+        out_dec(o, st->cycles);
+        if (st->reg < 0)
+            out_str(o, " cycles, unit busy\n");
+        else
+        {
+            out_str(o, " cycles, waits for ");
+            if (st->reg >= 32)
+                out_freg(o, st->reg - 32);
+            else
+                out_reg(o, st->reg);
+            out_str(o, " from ");
+            out_where(o, st->from);
+            out_char(o, '\n');
+        }
+        out_line_end(o);
+    }
+    printf("ev5: %d functions, %d insns, %d cycles, ipc %d.%02d\n",
+        funcs, words, (int)total, total ? (int)(words * 100LL / total / 100) : 0,
+        total ? (int)(words * 100LL / total % 100) : 0);
+}
+
+/* instruction mix (--stats): counts by format, by op and by function
+   and the nop, unop and fnop padding as the listing would name it, in
+   one pass over the words without decoding or formatting them */
+
+int stats_mode;
+
+const char *format_names[] =
+{
+    "___", "Pcd", "Bra", "Mem", "Mfc", "Mbr", "Opr", "F_P"
+};
+
+int is_padding(uint32_t code)
+{
+    return (code & 0xffe0ffff) == 0x2fe00000  /* unop: ldq_u zero,0(rb) */
+        || (code & 0xffff1fff) == 0x47ff041f  /* nop: bis zero,zero,zero */
+        || code == 0x5fff041f;                /* fnop: cpys f31,f31,f31 */
+}
+
+void out_count(struct Output *o, int count, int total)
+{
+    out_dec(o, count);
+    out_str(o, " insns, ");
+    out_dec(o, count * 4);
+    out_str(o, " bytes, ");
+    out_ratio(o, (int64_t)count * 100, total);
+    out_str(o, "%");
+}
+
+void out_function_stats(struct Output *o, int start, int end, int padding)
+{
+    int s = symbol_at(start);
+    out_str(o, "0x");
+    out_hex(o, text_addr + (uint64_t)start * 4, 8);
+    out_str(o, ": ");
+    if (s >= 0)
+        out_name(o, symbols[s].name);
+    else
+        out_str(o, "(no symbol)");
+    out_str(o, ": ");
+    out_dec(o, end - start);
+    out_str(o, " insns, ");
+    out_dec(o, (end - start) * 4);
+    out_str(o, " bytes, ");
+    out_dec(o, padding);
+    out_str(o, " padding\n");
+    out_line_end(o);
+}
+
+void write_stats(struct Output *o)
+{
+    const uint32_t *w = (const uint32_t *)text_buf;
+    int words = (int)(text_size / 4), i, j, start = 0, padding = 0, total_padding = 0;
+    int format_count[8], *op_count = (int *)malloc(oplen * sizeof(int)), *order;
+    if (!op_count || !(order = (int *)malloc(oplen * sizeof(int))))
+    {
+        printf("can not allocate statistics\n");
+        free(op_count);
+        return;
+    }
+    memset(format_count, 0, sizeof(format_count));
+    memset(op_count, 0, oplen * sizeof(int));
+    out_str(o, "functions:\n");
+    for (i = 0; i < words; i++)
+    {
+        uint32_t code = w[i];
+        int index = get_index(code);
+        if (i > start && symbol_at(i) >= 0)
+        {
+            out_function_stats(o, start, i, padding);
+            start = i;
+            padding = 0;
+        }
+        format_count[formats[code >> 26]]++;
+        op_count[index]++;
+        if (is_padding(code)) padding++, total_padding++;
+        if (opcodes[index] == Ret)
+        {
+            out_function_stats(o, start, i + 1, padding);
+            start = i + 1;
+            padding = 0;
+        }
+    }
+    if (start < words) out_function_stats(o, start, words, padding);
+    out_str(o, "\nformats:\n");
+    out_line_end(o);
+    for (i = 0; i < 8; i++)
+    {
+        if (!format_count[i]) continue;
+        out_str(o, format_names[i]);
+        out_str(o, ": ");
+        out_count(o, format_count[i], words);
+        out_char(o, '\n');
+        out_line_end(o);
+    }
+    /* ops by count, most frequent first */
+    for (i = 0, j = 0; i < oplen; i++)
+    {
+        int k;
+        if (!op_count[i]) continue;
+        for (k = j++; k > 0 && op_count[order[k - 1]] < op_count[i]; k--) order[k] = order[k - 1];
+        order[k] = i;
+    }
+    out_str(o, "\nops:\n");
+    out_line_end(o);
+    for (i = 0; i < j; i++)
+    {
+        out_str(o, opnames[order[i]]);
+        out_str(o, ": ");
+        out_count(o, op_count[order[i]], words);
+        out_char(o, '\n');
+        out_line_end(o);
+    }
+    out_str(o, "\npadding: ");
+    out_count(o, total_padding, words);
+    out_char(o, '\n');
+    printf("stats: %d insns, %d ops used, %d padding (%d%%)\n",
+        words, j, total_padding, words ? total_padding * 100 / words : 0);
+    free(order);
+    free(op_count);
+}
+
+/* cross reference file (-x): the references are written to <elf>.xref
+   next to the listing, as the edges in source order and in target order
+   with a table of the targets, so both directions are found by binary
+   search without disassembling again */
+
+#define XREF_VERSION 1
+
+struct XrefHeader
+{
+    char magic[4];                 /* "7dx" */
+    uint32_t version;
+    uint64_t text_addr;
+    uint32_t edge_count, target_count;
+    uint32_t by_source, by_target; /* file offsets of the edges in either order */
+    uint32_t targets, reserved;    /* file offset of the target table */
+};
+
+struct XrefTarget
+{
+    uint64_t addr;
+    uint32_t first, count;         /* range of the edges in target order */
+};
+
+int xref_mode;
+
+/* bottom-up merge sort by target, stable so each target's edges stay
+   in source order */
+int sort_xrefs(struct XrefEdge *e, int n)
+{
+    struct XrefEdge *tmp = (struct XrefEdge *)malloc(n * sizeof(struct XrefEdge) + 1), *a = e, *b = tmp, *t;
+    int w, i;
+    if (!tmp) return 0;
+    for (w = 1; w < n; w *= 2, t = a, a = b, b = t)
+    {
+        for (i = 0; i < n; i += 2 * w)
+        {
+            int l = i, m = i + w < n ? i + w : n, r = i + 2 * w < n ? i + 2 * w : n, j = m, k = i;
+            while (k < r) b[k++] = j >= r || (l < m && a[l].to <= a[j].to) ? a[l++] : a[j++];
+        }
+    }
+    for (i = 0; a != e && i < n; i++) e[i] = a[i];
+    free(tmp);
+    return 1;
+}
+
+void write_xref(const char *fn)
+{
+    struct XrefHeader h;
+    struct XrefEdge *sorted = (struct XrefEdge *)malloc(xref_count * sizeof(struct XrefEdge) + 1);
+    struct XrefTarget *targets = (struct XrefTarget *)malloc(xref_count * sizeof(struct XrefTarget) + 1);
+    int i, n = 0;
+    FILE *f;
+    for (i = 0; sorted && i < xref_count; i++) sorted[i] = xrefs[i];
+    if (!sorted || !targets || !sort_xrefs(sorted, xref_count))
+    {
+        printf("can not allocate cross references\n");
+        free(targets);
+        free(sorted);
+        return;
+    }
+    for (i = 0; i < xref_count; i++)
+    {
+        if (i == 0 || sorted[i].to != sorted[i - 1].to)
+        {
+            targets[n].addr = sorted[i].to;
+            targets[n].first = i;
+            targets[n++].count = 0;
+        }
+        targets[n - 1].count++;
+    }
+    memset(&h, 0, sizeof(h));
+    h.magic[0] = '7';
+    h.magic[1] = 'd';
+    h.magic[2] = 'x';
+    h.version = XREF_VERSION;
+    h.text_addr = text_addr;
+    h.edge_count = xref_count;
+    h.target_count = n;
+    h.by_source = sizeof(struct XrefHeader);
+    h.by_target = h.by_source + xref_count * sizeof(struct XrefEdge);
+    h.targets = h.by_target + xref_count * sizeof(struct XrefEdge);
+    printf("%s: %d references, %d targets\n", fn, xref_count, n);
+    if ((f = fopen(fn, "wb")) != 0)
+    {
+        fwrite(&h, sizeof(h), 1, f);
+        fwrite(xrefs, sizeof(struct XrefEdge), xref_count, f);
+        fwrite(sorted, sizeof(struct XrefEdge), xref_count, f);
+        fwrite(targets, sizeof(struct XrefTarget), n, f);
+        fclose(f);
+    }
+    free(targets);
+    free(sorted);
+}
+
+void print_edge(const struct XrefEdge *e)
+{
+    printf("  0x%08x: %s 0x%08x\n", e->from & ~(uint64_t)3, xref_kinds[e->from & 3], e->to);
+}
+
+/* --refs addr[,end]: the references to addr and from [addr, end) */
+void query_xref(const char *src, uint64_t start, uint64_t end)
+{
+    char fn[256];
+    struct Elf x;
+    const struct XrefHeader *h;
+    const struct XrefEdge *edges, *sorted;
+    const struct XrefTarget *targets;
+    int lo, hi, i;
+    snprintf(fn, sizeof(fn), "%s.xref", src);
+    memset(&x, 0, sizeof(x));
+    if (!elf_load(&x, fn) || x.size < sizeof(struct XrefHeader)
+        || (h = (const struct XrefHeader *)x.data)->magic[0] != '7' || h->magic[1] != 'd' || h->magic[2] != 'x'
+        || h->version != XREF_VERSION
+        || h->targets > x.size || (x.size - h->targets) / sizeof(struct XrefTarget) < h->target_count
+        || h->by_source + (uint64_t)h->edge_count * sizeof(struct XrefEdge) > h->by_target
+        || h->by_target + (uint64_t)h->edge_count * sizeof(struct XrefEdge) > h->targets)
+    {
+        printf("%s: can not read cross references\n", fn);
+        elf_close(&x);
+        return;
+    }
+    edges = (const struct XrefEdge *)(x.data + h->by_source);
+    sorted = (const struct XrefEdge *)(x.data + h->by_target);
+    targets = (const struct XrefTarget *)(x.data + h->targets);
+    for (lo = 0, hi = h->target_count; lo < hi;)
+    {
+        int mid = (lo + hi) / 2;
+        if (targets[mid].addr < start) lo = mid + 1; else hi = mid;
+    }
+    printf("references to 0x%08x:\n", start);
+    if (lo < (int)h->target_count && targets[lo].addr == start && targets[lo].first < h->edge_count
+        && targets[lo].count <= h->edge_count - targets[lo].first)
+        for (i = 0; i < (int)targets[lo].count; i++) print_edge(&sorted[targets[lo].first + i]);
+    for (lo = 0, hi = h->edge_count; lo < hi;)
+    {
+        int mid = (lo + hi) / 2;
+        if ((edges[mid].from & ~(uint64_t)3) < start) lo = mid + 1; else hi = mid;
+    }
+    printf("references from 0x%08x-0x%08x:\n", start, end);
+    for (; lo < (int)h->edge_count && (edges[lo].from & ~(uint64_t)3) < end; lo++) print_edge(&edges[lo]);
+    elf_close(&x);
+}
+
+#ifndef __alpha
+/* parallel mode: workers format ranges of .text into their own buffers */
+
+struct Worker
+{
+    int start, end;
+    struct Output out;
+    struct SweepMiss *misses;      /* --sweep */
+    int miss_count, miss_size;
+    int64_t defined;
+#ifdef _MSC_VER
+    void *thread;
+#else
+    pthread_t thread;
+#endif
+};
+
+#ifdef _MSC_VER
+#define THREAD_MAIN(name) unsigned long __stdcall name(void *arg)
+#else
+#define THREAD_MAIN(name) void *name(void *arg)
+#endif
+
+/* the default of -j */
+int online_cpus()
+{
+#if defined(_MSC_VER)
+    return (int)GetActiveProcessorCount(0xffff);  /* ALL_PROCESSOR_GROUPS */
+#elif defined(_SC_NPROCESSORS_ONLN)
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+#else
+    return 1;
+#endif
+}
+
+void start_worker(struct Worker *w, THREAD_MAIN((*main)))
+{
+#ifdef _MSC_VER
+    w->thread = CreateThread(0, 0, main, w, 0, 0);
+#else
+    pthread_create(&w->thread, 0, main, w);
+#endif
+}
+
+void join_worker(struct Worker *w)
+{
+#ifdef _MSC_VER
+    WaitForSingleObject(w->thread, 0xffffffff);
+    CloseHandle(w->thread);
+#else
+    pthread_join(w->thread, 0);
+#endif
+}
+
+THREAD_MAIN(worker_main)
+{
+    struct Worker *w = (struct Worker *)arg;
+    format_text(&w->out, w->start, w->end);
+    return 0;
+}
+
+/* the first word from i on where format_text() starts a line as it
+   would in one pass: format_data() groups a run of data from its start,
+   so a range can not begin inside a run */
+int split_text(int i, int words)
+{
+    while (i < words && (leaders[i] & (LEADER | DATA)) == DATA && symbol_at(i) < 0) i++;
+    return i;
+}
+
+void format_parallel(struct Output *o)
+{
+    int i, k, words = (int)(text_size / 4), n = jobs < words ? jobs : words;
+    struct Worker *workers = (struct Worker *)malloc(n * sizeof(struct Worker));
+    for (i = 0; workers && i < n; i++)
+    {
+        struct Worker *w = &workers[i];
+        w->start = i > 0 ? workers[i - 1].end : 0;
+        w->end = i < n - 1 ? split_text((int)((int64_t)words * (i + 1) / n), words) * 4 : words * 4;
+        if (w->end < w->start) w->end = w->start;
+        w->out.size = (w->end - w->start) * 16 + OUT_LINE;
+        w->out.buf = (char *)malloc(w->out.size);
+        w->out.len = 0;
+        w->out.file = 0;
+        w->out.full = out_grow;
+        w->out.comment = 0;
+        if (!w->out.buf) break;
+    }
+    /* no room for the workers: one pass, as without -j */
+    if (!workers || i < n)
+    {
+        while (workers && i-- > 0) free(workers[i].out.buf);
+        free(workers);
+        format_text(o, 0, (int)text_size);
+        return;
+    }
+    for (i = 0; i < n; i++) start_worker(&workers[i], worker_main);
+    for (i = 0; i < n; i++)
+    {
+        struct Worker *w = &workers[i];
+        join_worker(w);
+        if (o->file)
+        {
+            out_flush(o);
+            fwrite(w->out.buf, w->out.len, 1, o->file);
+        }
+        else
+        {
+            while (o->len + w->out.len > o->size - OUT_LINE) o->full(o);
+            for (k = 0; k < w->out.len; k++) o->buf[o->len++] = w->out.buf[k];
+        }
+        free(w->out.buf);
+    }
+    free(workers);
 }
 
-uint64_t text_addr, text_size;
-char text_buf[65536];
+/* reference check (--check-refs): a synthetic function sets gp to
+   HOST_BASE and t12 to fputc, then overwrites t12 with each integer op
+   of opcode 0x1c before a jsr through it. Only the first jsr, where t12
+   still holds fputc, may resolve */
 
-int read_text_file(void *f)
+int check_refs()
 {
-    int i;
-    char buf[64], shstrtab[256];
-    uint16_t e_machine, e_shstrndx, e_shentsize, e_shnum;
-    uint64_t e_shoff, stroff, strsize, textoff = 0;
-
-    if (fread(buf, 64, 1, f) == 0)
+    static const int fncs[] =
+    {
+        0x00, 0x01, 0x30, 0x31, 0x32, 0x33, 0x34, 0x35,
+        0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0x3e, 0x3f
+    };
+    int i, r, words = 0, failed = 0, count = sizeof(fncs) / sizeof(int);
+    uint32_t *text = (uint32_t *)malloc((count * 3 + 6) * 4);
+    if (!text)
     {
-        printf("can not read ELF header.\n");
+        printf("can not allocate the check image\n");
         return 0;
     }
-    if (buf[0] != 0x7f || buf[1] != 'E' || buf[2] != 'L' || buf[3] != 'F')
+    text[words++] = 0x27bb00ee;                        /* ldah gp,0xee(t12) */
+    text[words++] = 0x23bd0000;                        /* lda gp,0(gp) */
+    text[words++] = 0x237d0004;                        /* lda t12,4(gp) */
+    text[words++] = 0x6b5b4000;                        /* jsr ra,(t12),0 */
+    for (i = 0; i < count; i++)
     {
-        printf("EI_MAG != { 0x7f, 'E', 'L', 'F' }\n");
-        return 0;
+        text[words++] = 0x237d0004;                    /* lda t12,4(gp) */
+        text[words++] = 0x73e2001b | fncs[i] << 5;     /* op zero,t1,t12 */
+        text[words++] = 0x6b5b4000;                    /* jsr ra,(t12),0 */
     }
-    if (buf[4] != 2)
+    text[words++] = 0x6bfa8001;                        /* ret */
+    elf_close(&elf);
+    text_addr = 0x10000;
+    text_size = (uint64_t)words * 4;
+    text_buf = (const char *)text;
+    insns = (struct DecodedInsn *)realloc(insns, (words + 1) * sizeof(struct DecodedInsn));
+    if (!insns || !analyze_text())
     {
-        printf("EI_CLASS != ELFCLASS64\n");
+        printf("can not set up the check image\n");
+        free(text);
         return 0;
     }
-    if (buf[5] != 1)
+    for (i = 3; i < words; i += 3)
     {
-        printf("EI_DATA != ELFDATA2LSB\n");
-        return 0;
+        uint64_t ad = text_addr + (uint64_t)i * 4;
+        int call = (r = find_xref(ad)) < xref_count && xrefs[r].from == (ad | XREF_CALL);
+        if (call != (i == 3) || (call && xrefs[r].to != HOST_BASE + 4))
+        {
+            printf("jsr at 0x%08x: %s\n", (int)ad, call ? "resolved after t12 was overwritten" : "not resolved to fputc");
+            failed++;
+        }
     }
+    printf("%d jsr through t12: %s\n", count + 1, failed ? "FAILED" : "ok");
+    free(text);
+    return !failed;
+}
+
+/* parallel check (--check-jobs): lists a synthetic image of code with
+   literal pools of 1 to CHECK_POOL words between branches, at an
+   address which is not 8-aligned, in one pass and with 2 to CHECK_JOBS
+   workers (or -j, when more), and reports each worker count whose
+   listing differs */
 
-    e_machine = *(uint16_t *)&buf[18];
-    e_shoff = *(uint64_t *)&buf[40];
-    e_shentsize = *(uint16_t *)&buf[58];
-    e_shnum = *(uint16_t *)&buf[60];
-    e_shstrndx = *(uint16_t *)&buf[62];
+#define CHECK_POOL 19
+#define CHECK_JOBS 16
 
-    if (e_machine != 0x9026)
+int check_jobs()
+{
+    int i, n, words = 0, failed = 0, saved = jobs, most = jobs > CHECK_JOBS ? jobs : CHECK_JOBS;
+    uint32_t *text = (uint32_t *)malloc(64 * (CHECK_POOL + 4) * 4);
+    struct Output serial, o;
+    if (!text)
     {
-        printf("e_machine != EM_ALPHA_EXP\n");
+        printf("can not allocate the check image\n");
         return 0;
     }
-    if (e_shoff == 0)
+    for (i = 0; i < 64; i++)
     {
-        printf("e_shoff == 0\n");
-        return 0;
+        int k, pool = i % CHECK_POOL + 1;
+        text[words++] = 0x40220401;                    /* addq t0,t1,t0 */
+        text[words++] = 0xc3e00000 | pool;             /* br over the pool */
+        for (k = 0; k < pool; k++) text[words++] = 0x01234567 * (uint32_t)(i + k + 1);
+        text[words++] = 0x44220402;                    /* or t0,t1,t1 */
     }
-    if (e_shstrndx == 0)
+    text[words++] = 0x6bfa8001;                        /* ret */
+    elf_close(&elf);
+    text_addr = 0x10004;
+    text_size = (uint64_t)words * 4;
+    text_buf = (const char *)text;
+    insns = (struct DecodedInsn *)realloc(insns, (words + 1) * sizeof(struct DecodedInsn));
+    serial.size = o.size = words * 64 + OUT_LINE;
+    serial.buf = (char *)malloc(serial.size);
+    o.buf = (char *)malloc(o.size);
+    if (!insns || !serial.buf || !o.buf || !analyze_text())
     {
-        printf("e_shstrndx == 0\n");
+        printf("can not set up the check image\n");
         return 0;
     }
-    if (fseek(f, (int)(e_shoff + e_shstrndx * e_shentsize + 24), 0) != 0 ||
-        fread(&stroff, sizeof(stroff), 1, f) == 0 ||
-        fread(&strsize, sizeof(strsize), 1, f) == 0 ||
-        strsize > sizeof(shstrtab) ||
-        fseek(f, (int)stroff, 0) != 0 ||
-        fread(shstrtab, (int)strsize, 1, f) == 0)
+    serial.len = 0;
+    serial.file = 0;
+    serial.full = out_grow;
+    serial.comment = 0;
+    format_text(&serial, 0, words * 4);
+    for (n = 2; n <= most; n++)
     {
-        printf("can not read shstrtab\n");
-        return 0;
+        jobs = n;
+        o.len = 0;
+        o.file = 0;
+        o.full = out_grow;
+        o.comment = 0;
+        format_parallel(&o);
+        for (i = 0; i < o.len && i < serial.len && o.buf[i] == serial.buf[i]; i++);
+        if (i < o.len || i < serial.len)
+        {
+            printf("-j %d: the listing differs from one pass at byte %d\n", n, i);
+            failed++;
+        }
     }
+    printf("%d words, -j 2..%d: %s\n", words, most, failed ? "FAILED" : "ok");
+    jobs = saved;
+    free(o.buf);
+    free(serial.buf);
+    free(text);
+    return !failed;
+}
+
+/* sweep (--sweep first,count): each defined word of first.. is listed
+   as if it were at address word * 4, as format_insn() writes it, and
+   the line is assembled again by the 7a parser of asm.h in the same
+   worker. Only the words which do not come back are printed, in order
+   of address, and then summed up by primary opcode. Workers take shards
+   of SWEEP_SHARD words from a shared counter, so none idles while
+   another has a slow range; the parser state is per thread */
+
+#ifdef _MSC_VER
+#define ASM_STATE __declspec(thread)
+#else
+#define ASM_STATE __thread
+#endif
+#define ASM_ERROR sweep_error
+
+ASM_STATE int sweep_words, sweep_failed;
+ASM_STATE uint64_t sweep_addr;
+ASM_STATE uint32_t sweep_got;
+
+int sweep_error(const char *format, ...)
+{
+    sweep_failed = 1;
+    return 0;
+}
+
+void out_word(uint64_t ad, uint32_t v, int patch)
+{
+    if (!patch) sweep_words++;
+    sweep_addr = ad;
+    sweep_got = patch ? sweep_got | v : v;
+}
 
-    if (fseek(f, (int)e_shoff, 0) != 0)
+void pending_word(uint64_t ad, int n)
+{
+}
+
+#include "asm.h"
+
+#define SWEEP_SHARD 4096
+
+struct SweepMiss
+{
+    uint32_t word, got;
+    int error;  /* the line assembled to no single word, got is unset */
+};
+
+volatile int64_t sweep_next;
+int64_t sweep_end;
+
+int64_t take_sweep_shard()
+{
+#ifdef _MSC_VER
+    return _InterlockedExchangeAdd64(&sweep_next, SWEEP_SHARD);
+#else
+    return __sync_fetch_and_add(&sweep_next, SWEEP_SHARD);
+#endif
+}
+
+void add_miss(struct Worker *w, uint32_t word)
+{
+    struct SweepMiss *m;
+    if (w->miss_count == w->miss_size)
     {
-        printf("can not read section headers\n");
-        return 0;
+        int size = w->miss_size ? w->miss_size * 2 : 1024;
+        if (!(m = (struct SweepMiss *)realloc(w->misses, size * sizeof(struct SweepMiss)))) return;
+        w->misses = m;
+        w->miss_size = size;
     }
-    for (i = 0; i < e_shnum; i++)
+    m = &w->misses[w->miss_count++];
+    m->word = word;
+    m->got = sweep_got;
+    m->error = sweep_failed || sweep_words != 1 || sweep_addr != (uint64_t)word * 4;
+}
+
+/* lists the word at address word * 4 into o, one line */
+void sweep_line(struct Output *o, uint32_t word)
+{
+    struct DecodedInsn d;
+    uint64_t ad = (uint64_t)word * 4;
+    decode(&d, ad, word);
+    out_str(o, "0x");
+    out_hex(o, ad, 8);
+    out_str(o, ": ");
+    format_insn(o, &d);
+}
+
+THREAD_MAIN(sweep_main)
+{
+    struct Worker *w = (struct Worker *)arg;
+    int64_t first, end, v;
+    while ((first = take_sweep_shard()) < sweep_end)
     {
-        const char *name;
-        if (fread(buf, 64, 1, f) == 0) break;
-        name = shstrtab + *(uint32_t *)buf;
-        if (strcmp(name, ".text") == 0)
+        end = first + SWEEP_SHARD < sweep_end ? first + SWEEP_SHARD : sweep_end;
+        for (v = first; v < end; v++)
         {
-            text_addr = *(uint64_t *)&buf[16];
-            textoff = *(uint64_t *)&buf[24];
-            text_size = *(uint64_t *)&buf[32];
-            break;
+            if (get_index((uint32_t)v) == 0) continue;
+            w->defined++;
+            w->out.len = 0;
+            sweep_line(&w->out, (uint32_t)v);
+            out_char(&w->out, '\n');
+            out_line_end(&w->out);
+            /* the newline is the sentinel */
+            src_p = w->out.buf;
+            src_end = w->out.buf + w->out.len - 1;
+            line = 1;
+            sweep_words = sweep_failed = 0;
+            assemble_lines();
+            if (label_count > 0)
+            {
+                sweep_failed = 1;
+                reset_labels();
+            }
+            if (sweep_failed || sweep_words != 1 || sweep_addr != (uint64_t)v * 4 || sweep_got != (uint32_t)v)
+                add_miss(w, (uint32_t)v);
         }
     }
-    if (textoff == 0 ||
-        text_size > sizeof(text_buf) ||
-        fseek(f, (int)textoff, 0) != 0 ||
-        fread(text_buf, (int)text_size, 1, f) == 0)
+    return 0;
+}
+
+void sweep(uint64_t first, uint64_t count)
+{
+    int64_t defined = 0, total = 0, counts[64];
+    uint32_t bits[64];
+    int i, n = jobs > 1 ? jobs : 1, *at = (int *)malloc(n * sizeof(int));
+    struct Worker *workers = (struct Worker *)malloc(n * sizeof(struct Worker));
+    struct Output o;
+    for (i = 0; workers && at && i < n; i++)
     {
-        printf("can not read .text section\n");
-        return 0;
+        workers[i].out.size = OUT_LINE * 2;
+        if (!(workers[i].out.buf = (char *)malloc(workers[i].out.size))) break;
     }
+    if (!workers || !at || i < n)
+    {
+        printf("can not allocate sweep workers\n");
+        while (workers && i-- > 0) free(workers[i].out.buf);
+        free(workers);
+        free(at);
+        return;
+    }
+    elf_close(&elf);
+    text_addr = text_size = 0;
+    sweep_next = (int64_t)first;
+    sweep_end = first + count < ((uint64_t)1 << 32) ? (int64_t)(first + count) : (int64_t)1 << 32;
+    for (i = 0; i < n; i++)
+    {
+        struct Worker *w = &workers[i];
+        w->out.len = 0;
+        w->out.file = 0;
+        w->out.full = out_grow;
+        w->out.comment = 0;
+        w->misses = 0;
+        w->miss_count = w->miss_size = 0;
+        w->defined = 0;
+        start_worker(w, sweep_main);
+    }
+    for (i = 0; i < n; i++)
+    {
+        join_worker(&workers[i]);
+        free(workers[i].out.buf);
+        defined += workers[i].defined;
+        at[i] = 0;
+    }
+    /* each worker took its shards in order, so merging gives the order of address */
+    memset(counts, 0, sizeof(counts));
+    memset(bits, 0, sizeof(bits));
+    o.buf = out_buf;
+    o.len = 0;
+    o.size = sizeof(out_buf);
+    o.file = stdout;
+    o.full = out_flush;
+    o.comment = 0;
+    for (;;)
+    {
+        struct SweepMiss *m = 0;
+        int next = 0;
+        for (i = 0; i < n; i++)
+        {
+            struct Worker *w = &workers[i];
+            if (at[i] < w->miss_count && (!m || w->misses[at[i]].word < m->word))
+            {
+                m = &w->misses[at[i]];
+                next = i;
+            }
+        }
+        if (!m) break;
+        at[next]++;
+        sweep_line(&o, m->word);
+        if (m->error)
+            out_str(&o, " -> error");
+        else
+        {
+            out_str(&o, " -> ");
+            out_hex(&o, m->got, 8);
+            bits[m->word >> 26] |= m->got ^ m->word;
+        }
+        out_char(&o, '\n');
+        out_line_end(&o);
+        counts[m->word >> 26]++;
+        total++;
+    }
+    out_flush(&o);
+    for (i = 0; i < n; i++) free(workers[i].misses);
+    free(workers);
+    free(at);
+    printf("swept %lld words, %lld defined, %lld mismatches\n",
+        (long long)(sweep_end - (int64_t)first), (long long)defined, (long long)total);
+    for (i = 0; i < 64; i++)
+        if (counts[i]) printf("opc %02x: %lld mismatches, bits %08x\n", i, (long long)counts[i], bits[i]);
+    fflush(stdout);
+}
 
+/* server mode: each line on stdin is a request of options and an image,
+   answered on stdout by any messages and then "ok <size>" and a listing
+   of that size, or "error". Opened images stay mapped and are reused
+   while their size and modification time are unchanged */
+
+#define CACHE_SIZE 8
+
+struct Image
+{
+    char path[256];
+    uint64_t stamp[3];
+    struct Elf elf;
+    int used;
+};
+
+struct Image cache[CACHE_SIZE];
+int cache_clock;
+
+/* size and modification time, from the struct stat layout of Linux
+   (x86_64 and the generic one agree) or of _stat64 */
+int file_stamp(const char *fn, uint64_t *stamp)
+{
+#if defined(_MSC_VER)
+    struct Stat st;
+    if (_stat64(fn, &st) != 0) return 0;
+    stamp[0] = st.st_size;
+    stamp[1] = st.st_mtime;
+    stamp[2] = 0;
+#elif defined(HAVE_STAT)
+    struct Stat st;
+    if (stat(fn, &st) != 0) return 0;
+    stamp[0] = st.st_size;
+    stamp[1] = st.st_mtime;
+    stamp[2] = st.st_mtime_nsec;
+#else
+    /* no struct stat is declared for this host: the size and a hash of
+       the contents */
+    char buf[4096];
+    FILE *f = fopen(fn, "rb");
+    int i, n;
+    if (!f) return 0;
+    stamp[0] = 0;
+    stamp[1] = 0xcbf29ce484222325ull;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+    {
+        stamp[0] += n;
+        for (i = 0; i < n; i++) stamp[1] = hash_word(stamp[1], (unsigned char)buf[i]);
+    }
+    fclose(f);
+    stamp[2] = 0;
+#endif
     return 1;
 }
 
-int read_text(const char *fn)
+int open_image(const char *fn)
 {
-    int ret = 0;
-    FILE *f = fopen(fn, "rb");
-    if (f)
+    uint64_t stamp[3];
+    struct Image *im = 0;
+    int i, hit = 0;
+    if (!file_stamp(fn, stamp) || strlen(fn) >= sizeof(im->path))
     {
-        ret = read_text_file(f);
-        fclose(f);
+        printf("can not open %s\n", fn);
+        return 0;
     }
-    return ret;
+    for (i = 0; i < CACHE_SIZE && !im; i++)
+        if (cache[i].elf.data && strcmp(cache[i].path, fn) == 0) im = &cache[i];
+    if (im)
+        hit = im->stamp[0] == stamp[0] && im->stamp[1] == stamp[1] && im->stamp[2] == stamp[2];
+    else
+    {
+        /* the least recently used entry */
+        for (i = 0, im = cache; i < CACHE_SIZE; i++)
+            if (cache[i].used < im->used) im = &cache[i];
+        strncpy(im->path, fn, sizeof(im->path));
+    }
+    if (!hit)
+    {
+        elf_close(&im->elf);
+        if (!elf_open(&im->elf, fn))
+        {
+            im->used = 0;
+            return 0;
+        }
+        for (i = 0; i < 3; i++) im->stamp[i] = stamp[i];
+    }
+    im->used = ++cache_clock;
+    elf = im->elf;
+    return load_text();
+}
+
+int read_line(char *line, int size)
+{
+    int ch, len = 0;
+    while ((ch = fgetc(stdin)) != -1 && ch != '\n')
+        if (len < size - 1) line[len++] = (char)ch;
+    line[len] = 0;
+    return ch != -1 || len > 0;
+}
+
+int split_line(char *line, char **args, int max)
+{
+    int argc = 0;
+    for (;;)
+    {
+        while (*line == ' ' || *line == '\t' || *line == '\r') *(line++) = 0;
+        if (!*line || argc == max) return argc;
+        args[argc++] = line;
+        while (*line && *line != ' ' && *line != '\t' && *line != '\r') line++;
+    }
+}
+
+int parse_option(int argc, char **argv, int *i);
+
+void serve()
+{
+    char line[1024], *args[16];
+    struct Output o;
+    o.size = sizeof(out_buf);
+    o.buf = (char *)malloc(o.size);
+    o.file = 0;
+    o.full = out_grow;
+    o.comment = 0;
+    while (read_line(line, sizeof(line)))
+    {
+        int argc = split_line(line, args, 16), i;
+        if (argc == 0) continue;
+        range_start = 0;
+        range_end = ~(uint64_t)0;
+        for (i = 0; i < argc && args[i][0] == '-'; i++)
+            if (!parse_option(argc, args, &i)) break;
+        if (i != argc - 1)
+        {
+            printf("usage: [--start addr] [--end addr] [--around addr,n] elf\n");
+            printf("error\n");
+        }
+        else if (open_image(args[i]) && analyze_text())
+        {
+            o.len = 0;
+            format_text(&o, 0, (int)text_size);
+            printf("ok %d\n", o.len);
+            fwrite(o.buf, o.len, 1, stdout);
+        }
+        else
+            printf("error\n");
+        fflush(stdout);
+    }
+    free(o.buf);
 }
+#endif
 
 void exec(const char *src, const char *dst)
 {
     printf("%s -> %s\n", src, dst);
-    if (read_text(src))
+    if (read_text(src) && (stats_mode ? load_symbols((int)(text_size / 4)) : analyze_text()))
     {
         FILE *f;
         printf("text_addr: 0x%08x\n", text_addr);
         printf("text_size: 0x%08x\n", text_size);
-        f = fopen(dst, "w");
+        if (!stats_mode) print_host_calls();
+        f = fopen(dst, binary_mode ? "wb" : "w");
         if (f)
         {
-            int j;
-            for (j = 0; j < text_size; j += 4)
+            if (binary_mode)
+                write_binary(f);
+            else if (pipe_mode || stats_mode)
+            {
+                struct Output o;
+                o.buf = out_buf;
+                o.len = 0;
+                o.size = sizeof(out_buf);
+                o.file = f;
+                o.full = out_flush;
+                o.comment = 0;
+                if (stats_mode)
+                    write_stats(&o);
+                else
+                    write_pipeline(&o);
+                out_flush(&o);
+            }
+            else
             {
-                enum Op op;
-                fprintf(f, "0x%08x: ", (long)(text_addr + j));
-                op = disassemble(f, text_addr + j, *(uint32_t *)&text_buf[j]);
-                fprintf(f, "\n");
-                if (op == Ret) fprintf(f, "\n");
+                struct Output o;
+                o.buf = out_buf;
+                o.len = 0;
+                o.size = sizeof(out_buf);
+                o.file = f;
+                o.full = out_flush;
+                o.comment = 0;
+                if (use_cache)
+                    format_cached(&o, dst);
+#ifndef __alpha
+                else if (jobs > 1 && text_size >= 8)
+                    format_parallel(&o);
+#endif
+                else
+                    format_text(&o, 0, (int)text_size);
+                out_flush(&o);
             }
             fclose(f);
         }
+        if (xref_mode && !stats_mode)
+        {
+            char fn[256];
+            snprintf(fn, sizeof(fn), "%s.xref", src);
+            write_xref(fn);
+        }
+    }
+}
+
+/* benchmarks (-b): each pass runs over about BENCH_WORDS words of an
+   image or of a synthetic corpus and prints one JSON object per line, so
+   the results can be collected and compared between builds */
+
+#define BENCH_WORDS (4 << 20)
+
+int bench_sink;
+int bench_words = 1 << 16;
+const char *bench_mix;
+
+/* the time stamp counter, which runs at the nominal clock on current
+   x86; 0 where there is none */
+uint64_t read_cycles()
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    return __builtin_ia32_rdtsc();
+#elif defined(_MSC_VER)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+void print_bench(const char *name, const char *pass, int64_t words, long t, uint64_t cycles)
+{
+    printf("{\"corpus\": \"%s\", \"pass\": \"%s\", \"words\": %d", name, pass, (int)words);
+    if (t > 0)
+        printf(", \"ms\": %d, \"kwords_per_sec\": %d, \"kbytes_per_sec\": %d",
+            (int)(t * 1000 / CLOCKS_PER_SEC), (int)(words * CLOCKS_PER_SEC / t / 1000),
+            (int)(words * 4 * CLOCKS_PER_SEC / t / 1000));
+    if (cycles > 0 && words > 0)
+    {
+        int cpw = (int)(cycles * 100 / words);
+        printf(", \"cycles_per_word\": %d.%02d", cpw / 100, cpw % 100);
+    }
+    printf("}\n");
+}
+
+void out_discard(struct Output *o)
+{
+    bench_sink += o->len;
+    o->len = 0;
+}
+
+/* field columns: the fixed-position fields of a run of words in
+   structure-of-arrays form, timed against get_op() and decode_text().
+   Only the benchmark uses them: the analysis passes also need the
+   format, index and target of each word, which decode_text() puts in
+   the same record as these fields. With GCC or Clang on the host, 8
+   words are extracted per iteration with vector extensions, which
+   become AVX2 or SSE code depending on the -m flags; elsewhere a
+   scalar loop is used */
+
+struct Columns
+{
+    unsigned char *opcode, *ra, *rb, *rc;
+    int16_t *disp16;
+    int32_t *disp21;
+};
+
+#if !defined(__alpha) && (__GNUC__ >= 9 || defined(__clang__))
+#define VECTOR_COLUMNS
+typedef uint32_t v8u __attribute__((vector_size(32), aligned(4)));
+typedef int32_t v8i __attribute__((vector_size(32), aligned(4)));
+typedef int16_t v8h __attribute__((vector_size(16), aligned(2)));
+typedef unsigned char v8b __attribute__((vector_size(8), aligned(1)));
+#endif
+
+void extract_columns(struct Columns *c, const uint32_t *w, int count)
+{
+    int i = 0;
+#ifdef VECTOR_COLUMNS
+    for (; i + 8 <= count; i += 8)
+    {
+        v8u x = *(const v8u *)&w[i];
+        *(v8b *)&c->opcode[i] = __builtin_convertvector(x >> 26, v8b);
+        *(v8b *)&c->ra[i] = __builtin_convertvector((x >> 21) & 31, v8b);
+        *(v8b *)&c->rb[i] = __builtin_convertvector((x >> 16) & 31, v8b);
+        *(v8b *)&c->rc[i] = __builtin_convertvector(x & 31, v8b);
+        *(v8h *)&c->disp16[i] = __builtin_convertvector((v8i)(x << 16) >> 16, v8h);
+        *(v8i *)&c->disp21[i] = (v8i)(x << 11) >> 11;
+    }
+#endif
+    for (; i < count; i++)
+    {
+        uint32_t x = w[i];
+        c->opcode[i] = (unsigned char)(x >> 26);
+        c->ra[i] = (unsigned char)((x >> 21) & 31);
+        c->rb[i] = (unsigned char)((x >> 16) & 31);
+        c->rc[i] = (unsigned char)(x & 31);
+        c->disp16[i] = (int16_t)(x & 0xffff);
+        c->disp21[i] = (int32_t)(x << 11) >> 11;
+    }
+}
+
+/* times get_op(), decode_text(), extract_columns(), the whole listing
+   of .text as in exec() and format_insn() alone; text_addr, text_size,
+   text_buf and insns must be set up for text */
+void bench_text(const char *name, const char *text, int words)
+{
+    int i, j, rounds = BENCH_WORDS / words + 1;
+    int64_t total = (int64_t)rounds * words;
+    struct DecodedInsn *d = (struct DecodedInsn *)malloc(words * sizeof(struct DecodedInsn));
+    char *cols = (char *)malloc(words * 12);
+    struct Columns c;
+    struct Output o;
+    long t;
+    uint64_t cy;
+    if (!d || !cols)
+    {
+        printf("%s: can not allocate buffers\n", name);
+        free(cols);
+        free(d);
+        return;
+    }
+    c.disp21 = (int32_t *)cols;
+    c.disp16 = (int16_t *)(cols + words * 4);
+    c.opcode = (unsigned char *)(cols + words * 6);
+    c.ra = c.opcode + words;
+    c.rb = c.ra + words;
+    c.rc = c.rb + words;
+    o.buf = out_buf;
+    o.len = 0;
+    o.size = sizeof(out_buf);
+    o.file = 0;
+    o.full = out_discard;
+    o.comment = 0;
+    t = clock();
+    cy = read_cycles();
+    for (i = 0; i < rounds; i++)
+        for (j = 0; j < words; j++)
+            bench_sink += (int)get_op(((const uint32_t *)text)[j]);
+    cy = read_cycles() - cy;
+    print_bench(name, "get_op", total, clock() - t, cy);
+    t = clock();
+    cy = read_cycles();
+    for (i = 0; i < rounds; i++)
+        decode_text(d, 0, text, words);
+    cy = read_cycles() - cy;
+    print_bench(name, "decode", total, clock() - t, cy);
+    t = clock();
+    cy = read_cycles();
+    for (i = 0; i < rounds; i++)
+        extract_columns(&c, (const uint32_t *)text, words);
+    cy = read_cycles() - cy;
+    print_bench(name, "columns", total, clock() - t, cy);
+    t = clock();
+    cy = read_cycles();
+    for (i = 0; i < rounds; i++)
+    {
+        if (!analyze_text()) break;
+        format_text(&o, 0, words * 4);
+    }
+    cy = read_cycles() - cy;
+    print_bench(name, "listing", total, clock() - t, cy);
+    t = clock();
+    cy = read_cycles();
+    for (i = 0; i < rounds; i++)
+        for (j = 0; j < words; j++)
+        {
+            format_insn(&o, &insns[j]);
+            out_line_end(&o);
+        }
+    cy = read_cycles() - cy;
+    print_bench(name, "format", total, clock() - t, cy);
+    bench_sink += d[words - 1].index + c.disp21[words - 1] + o.len;
+    free(cols);
+    free(d);
+}
+
+void bench(const char *src)
+{
+    if (read_text(src) && text_size >= 4)
+        bench_text(src, text_buf, (int)(text_size / 4));
+}
+
+/* synthetic corpora: "random" is any word, the others are valid words
+   of the instructions of some formats with random fields, made from the
+   opcode tables; the seed is fixed so that runs compare */
+
+struct Mix
+{
+    const char *name;
+    int formats;  /* bit set of enum Format, 0: any word */
+};
+
+const struct Mix mixes[] =
+{
+    { "random", 0 },
+    { "operate", 1 << Opr },
+    { "memory", 1 << Mem | 1 << Mfc },
+    { "fp", 1 << F_P },
+    { "branch", 1 << Bra | 1 << Mbr },
+    { "mixed", 1 << Pcd | 1 << Bra | 1 << Mem | 1 << Mfc | 1 << Mbr | 1 << Opr | 1 << F_P },
+    { 0, 0 }
+};
+
+uint32_t make_word(int index, uint32_t r)
+{
+    int op = (int)opcodes[index], opc = op >> 16, subop = op & 0xffff;
+    const struct Decoder *d = &decoders[opc];
+    uint32_t code = (r & 0x03ffffff) & ~(uint32_t)d->zero & ~((uint32_t)d->mask << d->shift);
+    /* subop of 0x18 is the whole function code, as in DECODE_SLOT */
+    return (uint32_t)opc << 26 | code | (opc == 0x18 ? (uint32_t)subop : (uint32_t)subop << d->shift);
+}
+
+void bench_synthetic(const struct Mix *m)
+{
+    int i, n = 0, words = bench_words;
+    short *pool = (short *)malloc(oplen * sizeof(short));
+    uint32_t x = 1, *text = (uint32_t *)malloc(words * 4);
+    struct DecodedInsn *d = (struct DecodedInsn *)realloc(insns, (words + 1) * sizeof(struct DecodedInsn));
+    if (!pool || !text || !d)
+    {
+        printf("%s: can not allocate corpus\n", m->name);
+        free(text);
+        free(pool);
+        return;
+    }
+    insns = d;
+    for (i = 1; i < oplen; i++)
+        if (opcodes[i] != UNDEF && (m->formats >> formats[(int)opcodes[i] >> 16] & 1)) pool[n++] = (short)i;
+    for (i = 0; i < words;)
+    {
+        x = x * 1103515245 + 12345;
+        if (m->formats == 0)
+            text[i++] = x ^ (x >> 15);
+        else
+        {
+            uint32_t w = make_word(pool[(x >> 16) % n], x ^ (x << 13));
+            if (get_index(w) != 0) text[i++] = w;
+        }
     }
+    elf_close(&elf);
+    text_addr = 0x10000;
+    text_size = (uint64_t)words * 4;
+    text_buf = (const char *)text;
+    bench_text(m->name, text_buf, words);
+    free(text);
+    free(pool);
 }
 
 #ifdef _MSC_VER
@@ -1243,27 +3190,168 @@ const char *tests[] =
     "1", "2", "3", "4", "5", "6", "7t", "7d", "7a", 0
 };
 
+/* 0x for hex, otherwise decimal; returns the rest of the string */
+const char *parse_num(const char *s, uint64_t *v)
+{
+    *v = 0;
+    if (s[0] == '0' && s[1] == 'x')
+    {
+        for (s += 2;; s++)
+        {
+            int ch = *s;
+            if ('0' <= ch && ch <= '9')
+                *v = *v * 16 + ch - '0';
+            else if ('a' <= (ch | 0x20) && (ch | 0x20) <= 'f')
+                *v = *v * 16 + (ch | 0x20) - 'a' + 10;
+            else
+                return s;
+        }
+    }
+    for (; '0' <= *s && *s <= '9'; s++) *v = *v * 10 + *s - '0';
+    return s;
+}
+
+/* a,b */
+int parse_pair(const char *s, uint64_t *a, uint64_t *b)
+{
+    s = parse_num(s, a);
+    return *s == ',' && !*parse_num(s + 1, b);
+}
+
+/* addr,n: n instructions before and after addr */
+int parse_around(const char *s)
+{
+    uint64_t ad, n;
+    if (!parse_pair(s, &ad, &n)) return 0;
+    range_start = ad > n * 4 ? ad - n * 4 : 0;
+    range_end = ad + n * 4 + 4;
+    return 1;
+}
+
+/* the options with a value, for the command line and server requests */
+int parse_option(int argc, char **argv, int *i)
+{
+    const char *opt = argv[*i], *v = *i + 1 < argc ? argv[*i + 1] : 0;
+    if (!v)
+        return 0;
+    else if (strcmp(opt, "-j") == 0)
+    {
+        jobs = atoi(v);
+        jobs_given = 1;
+    }
+    else if (strcmp(opt, "--start") == 0)
+    {
+        if (*parse_num(v, &range_start)) return 0;
+    }
+    else if (strcmp(opt, "--end") == 0)
+    {
+        if (*parse_num(v, &range_end)) return 0;
+    }
+    else if (strcmp(opt, "--around") == 0)
+    {
+        if (!parse_around(v)) return 0;
+    }
+    else
+        return 0;
+    (*i)++;
+    return 1;
+}
+
 int main(int argc, char *argv[])
 {
-    init_table();
-    if (argc < 2)
+    int i, bench_mode = 0, refs_mode = 0;
+    uint64_t refs_start = 0, refs_end = 0;
+#ifndef __alpha
+    int server_mode = 0, sweep_mode = 0, check_mode = 0;
+    uint64_t sweep_first = 0, sweep_count = 0;
+#endif
+    for (i = 1; i < argc && argv[i][0] == '-'; i++)
+    {
+        if (strcmp(argv[i], "-b") == 0)
+            bench_mode = 1;
+        else if (strcmp(argv[i], "-c") == 0)
+            use_cache = 1;
+        else if (strcmp(argv[i], "--words") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0)
+            bench_words = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--mix") == 0 && i + 1 < argc)
+            bench_mix = argv[++i];
+        else if (strcmp(argv[i], "-r") == 0)
+            binary_mode = 1;
+        else if (strcmp(argv[i], "-p") == 0)
+            pipe_mode = 1;
+        else if (strcmp(argv[i], "--stats") == 0)
+            stats_mode = 1;
+        else if (strcmp(argv[i], "-x") == 0)
+            xref_mode = 1;
+        else if (strcmp(argv[i], "--refs") == 0 && i + 1 < argc
+            && (parse_pair(argv[i + 1], &refs_start, &refs_end) || !*parse_num(argv[i + 1], &refs_start)))
+        {
+            i++;
+            refs_mode = 1;
+        }
+#ifndef __alpha
+        else if (strcmp(argv[i], "-s") == 0)
+            server_mode = 1;
+        else if (strcmp(argv[i], "--check-jobs") == 0)
+            check_mode = 1;
+        else if (strcmp(argv[i], "--check-refs") == 0)
+            check_mode = 2;
+        else if (strcmp(argv[i], "--sweep") == 0 && i + 1 < argc
+            && parse_pair(argv[i + 1], &sweep_first, &sweep_count))
+        {
+            i++;
+            sweep_mode = 1;
+        }
+#endif
+        else if (!parse_option(argc, argv, &i))
+        {
+            printf("usage: 7d [-b [--words n] [--mix name]] [-c] [-p] [-r] [-s] [--stats] [-x] [--refs addr[,end]] [--sweep first,count] [--check-jobs] [--check-refs] [-j jobs] [--start addr] [--end addr] [--around addr,n] [elf ...]\n");
+            return 1;
+        }
+    }
+#ifndef __alpha
+    if (!jobs_given && (sweep_mode || check_mode == 1)) jobs = online_cpus();
+    if (jobs <= 0) jobs = 1;
+    if (check_mode)
+        return !(check_mode == 1 ? check_jobs() : check_refs());
+    else if (sweep_mode)
+        sweep(sweep_first, sweep_count);
+    else if (server_mode)
+        serve();
+    else
+#endif
+    if (refs_mode)
+    {
+        if (refs_end <= refs_start) refs_end = refs_start + 4;
+        for (; i < argc; i++) query_xref(argv[i], refs_start, refs_end);
+    }
+    else if (bench_mode)
+    {
+        if (i == argc)
+        {
+            const struct Mix *m;
+            for (m = mixes; m->name; m++)
+                if (!bench_mix || strcmp(bench_mix, m->name) == 0) bench_synthetic(m);
+        }
+        for (; i < argc; i++) bench(argv[i]);
+    }
+    else if (i == argc)
     {
         const char **t;
         for (t = tests; *t; t++)
         {
             char src[32], dst[32];
             snprintf(src, sizeof(src), CURDIR"%s", *t);
-            snprintf(dst, sizeof(dst), CURDIR"%s.asm", *t);
+            snprintf(dst, sizeof(dst), CURDIR"%s%s", *t, binary_mode ? ".7db" : pipe_mode ? ".ev5" : stats_mode ? ".stats" : ".asm");
             exec(src, dst);
         }
     }
     else
     {
-        int i;
-        for (i = 1; i < argc; i++)
+        for (; i < argc; i++)
         {
             char dst[256];
-            snprintf(dst, sizeof(dst), "%s.asm", argv[i]);
+            snprintf(dst, sizeof(dst), "%s%s", argv[i], binary_mode ? ".7db" : pipe_mode ? ".ev5" : stats_mode ? ".stats" : ".asm");
             exec(argv[i], dst);
         }
     }
@@ -1452,6 +3540,13 @@ int strcmp(const char *a, const char *b)
     return 0;
 }
 
+int strlen(const char *s)
+{
+    int ret = 0;
+    for (; *s; s++, ret++);
+    return ret;
+}
+
 char *strncpy(char *dst, const char *src, int size)
 {
     for (; size > 0; size--, dst++, src++)
@@ -1476,4 +3571,16 @@ void *memset(void *dst, int c, int len)
     for (i = 0; i < len; i++, d++) *d = (char)c;
     return dst;
 }
+
+#include "heap.h"
+
+int atoi(const char *s)
+{
+    return parseint(&s);
+}
+
+long clock()
+{
+    return -1;
+}
 #endif
@@ -26,6 +26,9 @@ int strcmp(const char *, const char *);
 char *strncpy(char *, const char *, int);
 char *strncat(char *, const char *, int);
 void *memset(void *, int, int);
+void *malloc(unsigned long);
+void *realloc(void *, unsigned long);
+void free(void *);
 #else
 typedef long long int64_t;
 typedef unsigned long long uint64_t;
@@ -47,109 +50,41 @@ int strcmp(const char *, const char *);
 char *strncpy(char *, const char *, int);
 char *strncat(char *, const char *, int);
 void *memset(void *, int, int);
+void *malloc(unsigned long);
+void *realloc(void *, unsigned long);
+void free(void *);
+#ifndef _MSC_VER
+int open(const char *, int, ...);
+int close(int);
+long lseek(int, long, int);
+void *mmap(void *, unsigned long, int, int, int, long);
+int munmap(void *, unsigned long);
 #endif
+#endif
+
+#include "elf.h"
 
 /* extractor implementation */
 
+struct Elf elf;
 uint64_t text_addr, text_size;
-char text_buf[65536];
+const char *text_buf;
 
-int read_text_file(FILE *f)
+int read_text(const char *fn)
 {
-    int i;
-    char buf[64], shstrtab[256];
-    uint16_t e_shstrndx, e_shentsize, e_shnum;
-    uint64_t e_shoff, stroff, strsize, textoff = 0;
-
-    if (fread(buf, 64, 1, f) == 0)
-    {
-        printf("can not read ELF header.\n");
-        return 0;
-    }
-    if (buf[0] != 0x7f || buf[1] != 'E' || buf[2] != 'L' || buf[3] != 'F')
-    {
-        printf("EI_MAG != { 0x7f, 'E', 'L', 'F' }\n");
-        return 0;
-    }
-    if (buf[4] != 2)
-    {
-        printf("EI_CLASS != ELFCLASS64\n");
-        return 0;
-    }
-    if (buf[5] != 1)
-    {
-        printf("EI_DATA != ELFDATA2LSB\n");
-        return 0;
-    }
-
-    e_shoff = *(uint64_t *)&buf[40];
-    e_shentsize = *(uint16_t *)&buf[58];
-    e_shnum = *(uint16_t *)&buf[60];
-    e_shstrndx = *(uint16_t *)&buf[62];
-
-    if (e_shoff == 0)
-    {
-        printf("e_shoff == 0\n");
-        return 0;
-    }
-    if (e_shstrndx == 0)
-    {
-        printf("e_shstrndx == 0\n");
-        return 0;
-    }
-    if (fseek(f, (int)(e_shoff + e_shstrndx * e_shentsize + 24), 0) != 0 ||
-        fread(&stroff, sizeof(stroff), 1, f) == 0 ||
-        fread(&strsize, sizeof(strsize), 1, f) == 0 ||
-        strsize > sizeof(shstrtab) ||
-        fseek(f, (int)stroff, 0) != 0 ||
-        fread(shstrtab, (int)strsize, 1, f) == 0)
-    {
-        printf("can not read shstrtab\n");
-        return 0;
-    }
-
-    if (fseek(f, (int)e_shoff, 0) != 0)
-    {
-        printf("can not read section headers\n");
-        return 0;
-    }
-    for (i = 0; i < e_shnum; i++)
-    {
-        const char *name;
-        if (fread(buf, 64, 1, f) == 0) break;
-        name = shstrtab + *(uint32_t *)buf;
-        if (strcmp(name, ".text") == 0)
-        {
-            text_addr = *(uint64_t *)&buf[16];
-            textoff = *(uint64_t *)&buf[24];
-            text_size = *(uint64_t *)&buf[32];
-            break;
-        }
-    }
-    if (textoff == 0 ||
-        text_size > sizeof(text_buf) ||
-        fseek(f, (int)textoff, 0) != 0 ||
-        fread(text_buf, (int)text_size, 1, f) == 0)
+    const struct Elf64_Shdr *sh;
+    elf_close(&elf);
+    if (!elf_open(&elf, fn)) return 0;
+    if (!(sh = elf_section(&elf, ".text")) || !(text_buf = elf_contents(&elf, sh)))
     {
         printf("can not read .text section\n");
         return 0;
     }
-
+    text_addr = sh->sh_addr;
+    text_size = sh->sh_size;
     return 1;
 }
 
-int read_text(const char *fn)
-{
-    int ret = 0;
-    FILE *f = fopen(fn, "rb");
-    if (f)
-    {
-        ret = read_text_file(f);
-        fclose(f);
-    }
-    return ret;
-}
-
 void exec(const char *src, const char *dst)
 {
     printf("%s -> %s\n", src, dst);
@@ -406,4 +341,6 @@ void *memset(void *dst, int c, int len)
     for (i = 0; i < len; i++, d++) *d = (char)c;
     return dst;
 }
+
+#include "heap.h"
 #endif
@@ -0,0 +1,130 @@
+/* Alpha tables generated from alpha.def */
+
+enum Format
+{
+    ___, Pcd, Bra, Mem, Mfc, Mbr, Opr, F_P
+};
+
+const enum Format formats[] =
+{
+#define OPC(opc, format, shift, mask, zero) format,
+#include "alpha.def"
+};
+
+enum Regs
+{
+    /* r00     */ V0,
+    /* r01-r08 */ T0, T1, T2, T3, T4, T5, T6, T7,
+    /* r09-r14 */ S0, S1, S2, S3, S4, S5,
+    /* r15     */ FP,
+    /* r16-r21 */ A0, A1, A2, A3, A4, A5,
+    /* r22-r25 */ T8, T9, T10, T11,
+    /* r26     */ RA,
+    /* r27     */ T12,
+    /* r28     */ AT,
+    /* r29     */ GP,
+    /* r30     */ SP,
+    /* r31     */ Zero,
+};
+
+const char *regname[] =
+{
+    /* r00     */ "v0",
+    /* r01-r08 */ "t0", "t1", "t2", "t3", "t4", "t5", "t6", "t7",
+    /* r09-r14 */ "s0", "s1", "s2", "s3", "s4", "s5",
+    /* r15     */ "fp",
+    /* r16-r21 */ "a0", "a1", "a2", "a3", "a4", "a5",
+    /* r22-r25 */ "t8", "t9", "t10", "t11",
+    /* r26     */ "ra",
+    /* r27     */ "t12",
+    /* r28     */ "at",
+    /* r29     */ "gp",
+    /* r30     */ "sp",
+    /* r31     */ "zero",
+};
+
+const int reglen = sizeof(regname) / sizeof(const char *);
+
+enum Op
+{
+    UNDEF = -1,
+#define OP(name, mne, opc, subop) name = (opc << 16) | subop,
+#define ALIAS(name, mne, opc, subop) name = (opc << 16) | subop,
+#include "alpha.def"
+};
+
+/* index of opnames/opcodes, 0: UNDEF */
+enum OpIndex
+{
+    I_UNDEF,
+#define OP(name, mne, opc, subop) I_##name,
+#define ALIAS(name, mne, opc, subop) I_##name,
+#include "alpha.def"
+};
+
+const char *opnames[] =
+{
+    "UNDEF",
+#define OP(name, mne, opc, subop) mne,
+#define ALIAS(name, mne, opc, subop) mne,
+#include "alpha.def"
+};
+
+const enum Op opcodes[] =
+{
+    UNDEF,
+#define OP(name, mne, opc, subop) name,
+#define ALIAS(name, mne, opc, subop) name,
+#include "alpha.def"
+};
+
+const int oplen = sizeof(opnames) / sizeof(const char *);
+
+/* decoder: subop = (code >> shift) & mask, (code & zero) must be 0 */
+
+struct Decoder
+{
+    int shift, mask, zero, base;
+};
+
+enum DecodeBase
+{
+#define OPC(opc, format, shift, mask, zero) Base_##opc, Last_##opc = Base_##opc + mask,
+#include "alpha.def"
+    DecodeSize
+};
+
+const struct Decoder decoders[] =
+{
+#define OPC(opc, format, shift, mask, zero) { shift, mask, zero, Base_##opc },
+#include "alpha.def"
+};
+
+/* subop of 0x18 is the whole 16bit function code */
+#define DECODE_SLOT(opc, subop) (Base_##opc + (opc == 0x18 ? subop >> 10 : subop))
+
+const short decode_tab[DecodeSize] =
+{
+#define OP(name, mne, opc, subop) [DECODE_SLOT(opc, subop)] = I_##name,
+#include "alpha.def"
+};
+
+enum POp
+{
+#define POP(name, mne, op) name,
+#include "alpha.def"
+};
+
+const char *popnames[] =
+{
+#define POP(name, mne, op) mne,
+#include "alpha.def"
+};
+
+const enum Op popcodes[] =
+{
+#define POP(name, mne, op) op,
+#include "alpha.def"
+};
+
+const int poplen = sizeof(popnames) / sizeof(const char *);
@@ -0,0 +1,948 @@
+/* the 7a parser and encoder: assembles the lines of [src_p, src_end)
+   from curad on. The includer defines out_word(), which stores a word
+   at an address or ORs a fixup into it, and pending_word(), called with
+   1 when a branch at the address waits for a label and with -1 when it
+   is patched. The state is per thread if ASM_STATE is defined so, and
+   errors go to ASM_ERROR, printf by default */
+
+#ifndef ASM_STATE
+#define ASM_STATE
+#endif
+#ifndef ASM_ERROR
+#define ASM_ERROR printf
+#endif
+
+void out_word(uint64_t ad, uint32_t v, int patch);
+void pending_word(uint64_t ad, int n);
+
+#define LOWER(ch) ('A' <= (ch) && (ch) <= 'Z' ? (ch) + 32 : (ch))
+
+/* mnemonic lookup: a hash-and-displace perfect hash over opnames and
+   popnames. Its tables in mnemonic.h are generated by 7a --mnemonics
+   with the displacement search in 7a.c, so nothing is built at startup;
+   mnemonic.h fails to compile when alpha.def no longer has the number
+   of mnemonics it was generated for */
+
+#define MNE_COUNT (sizeof(opnames) / sizeof(const char *) - 1 + sizeof(popnames) / sizeof(const char *))
+#define MNE_BUCKETS 256
+#define MNE_BITS 10
+
+#include "mnemonic.h"
+
+uint32_t hash_mnemonic(const char *s, int len)
+{
+    uint32_t h = 2166136261u;
+    int i;
+    for (i = 0; i < len; i++)
+    {
+        h ^= (unsigned char)LOWER(s[i]);
+        h *= 16777619;
+    }
+    return h;
+}
+
+int mnemonic_slot(uint32_t h, uint32_t disp)
+{
+    return (int)(((h ^ disp) * 0x9e3779b1u) >> (32 - MNE_BITS));
+}
+
+const char *mnemonic_name(int v)
+{
+    return v > 0 ? opnames[v] : popnames[~v];
+}
+/* returns an opnames index (> 0), ~popnames index (< 0) or 0 */
+int search_mnemonic(const char *s, int len)
+{
+    uint32_t h = hash_mnemonic(s, len);
+    int v = mne_slot[mnemonic_slot(h, mne_disp[h % MNE_BUCKETS])], i;
+    const char *name;
+    if (v == 0) return 0;
+    name = mnemonic_name(v);
+    for (i = 0; i < len; i++)
+        if (LOWER(s[i]) != name[i]) return 0;
+    return name[len] == 0 ? v : 0;
+}
+
+ASM_STATE uint64_t text_start, text_end, curad;
+ASM_STATE int line, curline;
+
+/* the source is [src_p, src_end) followed by a '\n' sentinel at
+   src_end, so the scanning loops below never test for the end */
+ASM_STATE const char *src_p, *src_end;
+
+enum Token
+{
+    EndF, EndL, Int, Hex, Oct, Symbol, Label, Sign, Addr
+};
+
+const char *tokenName[] =
+{
+    "endf", "endl", "int", "hex", "oct", "symbol", "label", "sign", "addr"
+};
+
+enum CharClass
+{
+    C_Space = 1, C_Num = 2, C_Oct = 4, C_Hex = 8, C_Letter = 16, C_Qual = 32
+};
+
+#define S C_Space
+#define O (C_Num | C_Oct | C_Hex | C_Letter)
+#define D (C_Num | C_Hex | C_Letter)
+#define H (C_Hex | C_Letter)
+#define L C_Letter
+#define Q C_Qual
+
+const unsigned char char_class[256] =
+{
+    S, S, S, S, S, S, S, S, S, S, 0, S, S, S, S, S, /* 0x00 */
+    S, S, S, S, S, S, S, S, S, S, S, S, S, S, S, S, /* 0x10 */
+    S, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, Q, /* 0x20 */
+    O, O, O, O, O, O, O, O, D, D, 0, 0, 0, 0, 0, 0, /* 0x30 */
+    0, H, H, H, H, H, H, L, L, L, L, L, L, L, L, L, /* 0x40 */
+    L, L, L, L, L, L, L, L, L, L, L, 0, 0, 0, 0, L, /* 0x50 */
+    0, H, H, H, H, H, H, L, L, L, L, L, L, L, L, L, /* 0x60 */
+    L, L, L, L, L, L, L, L, L, L, L, 0, 0, 0, 0, 0, /* 0x70 */
+};
+
+#undef S
+#undef O
+#undef D
+#undef H
+#undef L
+#undef Q
+
+#define CLASS(ch) char_class[(unsigned char)(ch)]
+
+void skip_line()
+{
+    while (*src_p != '\n') src_p++;
+    if (src_p < src_end)
+    {
+        src_p++;
+        line++;
+    }
+}
+
+void skip_space()
+{
+    while (CLASS(*src_p) & C_Space) src_p++;
+}
+
+/* tokens are spans [tok, tok + toklen) of src_buf */
+ASM_STATE const char *tok;
+ASM_STATE int toklen;
+ASM_STATE char token_buf[32];
+
+const char *span_str(const char *s, int len)
+{
+    if (len > sizeof(token_buf) - 1) len = sizeof(token_buf) - 1;
+    strncpy(token_buf, s, len);
+    token_buf[len] = 0;
+    return token_buf;
+}
+
+const char *token_str()
+{
+    return span_str(tok, toklen);
+}
+
+enum Token end_token(const char *p, enum Token token)
+{
+    toklen = (int)(p - tok);
+    src_p = p;
+    return token;
+}
+
+enum Token end_word(const char *p, enum Token token, enum Token label)
+{
+    end_token(p, token);
+    skip_space();
+    if (*src_p != ':') return token;
+    src_p++;
+    return label;
+}
+
+enum Token read_token()
+{
+    const char *p;
+    skip_space();
+    tok = p = src_p;
+    switch (*p)
+    {
+    case '\n':
+        toklen = 0;
+        if (p == src_end) return EndF;
+        src_p++;
+        line++;
+        return EndL;
+    case ';':
+        toklen = 0;
+        skip_line();
+        return EndL;
+    case '0':
+        if (p[1] == 'x')
+        {
+            for (p += 2; CLASS(*p) & C_Hex; p++);
+            return end_word(p, Hex, Addr);
+        }
+        else if (CLASS(p[1]) & C_Num)
+        {
+            for (p++; CLASS(*p) & C_Oct; p++);
+            return end_token(p, Oct);
+        }
+        return end_token(p + 1, Int);
+    }
+    if (CLASS(*p) & C_Num)
+    {
+        for (p++; CLASS(*p) & C_Num; p++);
+        return end_token(p, Int);
+    }
+    else if (CLASS(*p) & C_Letter)
+    {
+        /* '/' is taken for qualified mnemonics such as addq/v */
+        for (p++; CLASS(*p) & (C_Letter | C_Qual); p++);
+        return end_word(p, Symbol, Label);
+    }
+    return end_token(p + 1, Sign);
+}
+
+int is_num(int ch) { return '0' <= ch && ch <= '9'; }
+
+/* labels: spans of src_buf kept in a growable array and indexed by an
+   open-addressed hash table; a branch to a label not yet defined is
+   recorded as a fixup on the label's chain and patched when the label
+   is defined */
+
+struct Label
+{
+    const char *name;
+    int len, defined, fixup;
+    uint32_t hash;
+    uint64_t addr;
+};
+
+struct Fixup
+{
+    uint64_t addr;
+    int label, line, next;
+};
+
+ASM_STATE struct Label *labels;
+ASM_STATE int label_count, label_max;
+ASM_STATE int *label_hash, label_hash_size; /* label index + 1, 0: empty */
+ASM_STATE struct Fixup *fixups;
+ASM_STATE int fixup_count, fixup_max;
+
+uint32_t hash_label(const char *s, int len)
+{
+    uint32_t h = 2166136261u;
+    int i;
+    for (i = 0; i < len; i++)
+    {
+        h ^= (unsigned char)s[i];
+        h *= 16777619;
+    }
+    return h;
+}
+
+void reset_labels()
+{
+    label_count = fixup_count = 0;
+    if (label_hash) memset(label_hash, 0, label_hash_size * sizeof(int));
+}
+
+int *label_slot(const char *name, int len, uint32_t h)
+{
+    int i, mask = label_hash_size - 1;
+    for (i = h & mask;; i = (i + 1) & mask)
+    {
+        int *slot = &label_hash[i], j;
+        struct Label *l;
+        if (*slot == 0) return slot;
+        l = &labels[*slot - 1];
+        if (l->hash != h || l->len != len) continue;
+        for (j = 0; j < len && l->name[j] == name[j]; j++);
+        if (j == len) return slot;
+    }
+}
+
+int grow_labels()
+{
+    int i, size = label_hash_size ? label_hash_size * 2 : 1024;
+    int *hash = (int *)malloc(size * sizeof(int));
+    struct Label *ls = (struct Label *)realloc(labels, (size / 2) * sizeof(struct Label));
+    if (!hash || !ls)
+    {
+        ASM_ERROR("%d: error: too many labels\n", curline);
+        free(hash);
+        if (ls) labels = ls;
+        return 0;
+    }
+    free(label_hash);
+    labels = ls;
+    label_max = size / 2;
+    label_hash = hash;
+    label_hash_size = size;
+    memset(label_hash, 0, size * sizeof(int));
+    for (i = 0; i < label_count; i++)
+        *label_slot(labels[i].name, labels[i].len, labels[i].hash) = i + 1;
+    return 1;
+}
+
+/* returns the index of the label, adding it as undefined if needed */
+int find_label(const char *name, int len)
+{
+    uint32_t h = hash_label(name, len);
+    int *slot;
+    struct Label *l;
+    if (label_count == label_max && !grow_labels()) return -1;
+    slot = label_slot(name, len, h);
+    if (*slot) return *slot - 1;
+    l = &labels[label_count];
+    l->name = name;
+    l->len = len;
+    l->hash = h;
+    l->defined = 0;
+    l->fixup = -1;
+    l->addr = 0;
+    return (*slot = ++label_count) - 1;
+}
+
+
+void add_fixup(int label)
+{
+    struct Fixup *f;
+    if (fixup_count == fixup_max)
+    {
+        int max = fixup_max ? fixup_max * 2 : 1024;
+        f = (struct Fixup *)realloc(fixups, max * sizeof(struct Fixup));
+        if (!f)
+        {
+            ASM_ERROR("%d: error: too many fixups\n", curline);
+            return;
+        }
+        fixups = f;
+        fixup_max = max;
+    }
+    f = &fixups[fixup_count];
+    f->addr = curad;
+    f->label = label;
+    f->line = curline;
+    f->next = labels[label].fixup;
+    labels[label].fixup = fixup_count++;
+    pending_word(curad, 1);
+}
+
+int check_bra_disp(int disp)
+{
+    if (disp < -0x100000)
+        ASM_ERROR("%d: error: disp < -0x100000: -%x\n", curline, -disp);
+    else if (disp > 0xfffff)
+        ASM_ERROR("%d: error: disp > 0xfffff: %x\n", curline, disp);
+    else
+        return 1;
+    return 0;
+}
+
+void patch_fixup(struct Fixup *f)
+{
+    struct Label *l = &labels[f->label];
+    int line = curline, diff = (int)(l->addr - (f->addr + 4));
+    curline = f->line;
+    if (!l->defined)
+        ASM_ERROR("%d: error: undefined label: %s\n", curline, span_str(l->name, l->len));
+    else if ((diff & 3) != 0)
+        ASM_ERROR("%d: error: not align 4: %s\n", curline, span_str(l->name, l->len));
+    else if (check_bra_disp(diff >> 2))
+        out_word(f->addr, (diff >> 2) & 0x1fffff, 1);
+    curline = line;
+    f->label = -1;
+    pending_word(f->addr, -1);
+}
+
+void define_label(const char *name, int len)
+{
+    int i = find_label(name, len), j;
+    if (i < 0) return;
+    if (labels[i].defined)
+    {
+        ASM_ERROR("%d: error: label is already defined: %s\n", curline, span_str(name, len));
+        return;
+    }
+    labels[i].defined = 1;
+    labels[i].addr = curad;
+    for (j = labels[i].fixup; j >= 0; j = fixups[j].next) patch_fixup(&fixups[j]);
+    labels[i].fixup = -1;
+}
+
+
+uint64_t parse_uint(const char *n)
+{
+    uint64_t ret = 0;
+    char ch;
+    while (ch = *(n++))
+    {
+        int n;
+        if ('0' <= ch && ch <= '9')
+            n = ch - '0';
+        else
+            break;
+        ret *= 10;
+        ret += n;
+    }
+    return ret;
+}
+
+uint64_t parse_hex(const char *hex)
+{
+    uint64_t ret = 0;
+    char ch;
+    while (ch = *(hex++))
+    {
+        int n;
+        if ('0' <= ch && ch <= '9')
+            n = ch - '0';
+        else if ('A' <= ch && ch <= 'F')
+            n = ch - 'A' + 10;
+        else if ('a' <= ch && ch <= 'f')
+            n = ch - 'a' + 10;
+        else
+            break;
+        ret <<= 4;
+        ret += n;
+    }
+    return ret;
+}
+
+/* recognises r0-r31, f0-f31 and the ABI names by length and the first
+   characters, in place and case-insensitively */
+int parse_reg(enum Regs *reg, const char *s, int len)
+{
+    int c0 = LOWER(s[0]), c1 = len > 1 ? LOWER(s[1]) : 0, r = -1, n;
+    switch (len)
+    {
+    case 2:
+        n = c1 - '0';
+        if (is_num(c1))
+        {
+            switch (c0)
+            {
+            case 'r': case 'f': r = n; break;
+            case 'v': if (n == 0) r = V0; break;
+            case 't': r = n < 8 ? T0 + n : T8 + n - 8; break;
+            case 's': if (n < 6) r = S0 + n; break;
+            case 'a': if (n < 6) r = A0 + n; break;
+            }
+        }
+        else if (c0 == 'f' && c1 == 'p') r = FP;
+        else if (c0 == 'r' && c1 == 'a') r = RA;
+        else if (c0 == 'a' && c1 == 't') r = AT;
+        else if (c0 == 'g' && c1 == 'p') r = GP;
+        else if (c0 == 's' && c1 == 'p') r = SP;
+        break;
+    case 3:
+        if (!is_num(c1) || !is_num(s[2])) break;
+        n = (c1 - '0') * 10 + s[2] - '0';
+        if (c0 == 'r' || c0 == 'f')
+        {
+            if (n < 32) r = n;
+        }
+        else if (c0 == 't' && 10 <= n && n <= 12)
+            r = n == 12 ? T12 : T10 + n - 10;
+        break;
+    case 4:
+        if (c0 == 'z' && c1 == 'e' && LOWER(s[2]) == 'r' && LOWER(s[3]) == 'o') r = Zero;
+        break;
+    }
+    if (r < 0) return 0;
+    *reg = (enum Regs)r;
+    return 1;
+}
+
+int get_reg(enum Regs *reg, enum Token token, const char *msg)
+{
+    if (token == Symbol && parse_reg(reg, tok, toklen)) return 1;
+    ASM_ERROR("%d: error: %s required: %s\n", curline, msg ? msg : "register", token_str());
+    if (token != EndL) skip_line();
+    return 0;
+}
+
+int read_reg(enum Regs *reg, const char *msg)
+{
+    return get_reg(reg, read_token(), msg);
+}
+
+int is_sign(enum Token token, const char *sign)
+{
+    if (token == Sign && *tok == *sign) return 1;
+    ASM_ERROR("%d: error: '%s' required", curline, sign);
+    if (toklen != 0) ASM_ERROR(": %s", token_str());
+    ASM_ERROR("\n");
+    if (token != EndL) skip_line();
+    return 1;
+}
+
+int read_sign(const char *sign)
+{
+    return is_sign(read_token(), sign);
+}
+
+int parse_addr(enum Regs *reg, int *disp)
+{
+    int sign = 1;
+    enum Token token = read_token();
+    if (token == Sign && *tok == '-')
+    {
+        sign = -1;
+        token = read_token();
+    }
+    if (token == Int)
+    {
+        *disp = ((int)parse_uint(tok)) * sign;
+        sign = 0;
+        token = read_token();
+    }
+    else if (token == Hex)
+    {
+        *disp = ((int)parse_hex(tok + 2)) * sign;
+        sign = 0;
+        token = read_token();
+    }
+    if (!(token == Sign && *tok == '('))
+    {
+        if (sign != 0)
+        {
+            ASM_ERROR("%d: error: disp or addr required: %s\n", curline, token_str());
+            if (token != EndL) skip_line();
+            return 0;
+        }
+        else if (!(token == EndF || token == EndL))
+        {
+            ASM_ERROR("%d: error: disp or addr required\n", curline);
+            return 0;
+        }
+        *reg = Zero;
+    }
+    else if (!read_reg(reg, 0) || !read_sign(")"))
+        return 0;
+    return 1;
+}
+
+int parse_value(uint64_t *v)
+{
+    enum Token token = read_token();
+    switch (token)
+    {
+    case Int:
+        *v = parse_uint(tok);
+        return 1;
+    case Hex:
+        *v = parse_hex(tok + 2);
+        return 1;
+    case EndL:
+    case EndF:
+        ASM_ERROR("%d: error: value required\n", curline);
+        return 0;
+    }
+    ASM_ERROR("%d: error: value required: %s\n", curline, token_str());
+    if (token != EndL) skip_line();
+    return 0;
+}
+
+int parse_reg_or_value(enum Regs *reg, uint64_t *v)
+{
+    enum Token token = read_token();
+    switch (token)
+    {
+    case Int:
+        *v = parse_uint(tok);
+        return 2;
+    case Hex:
+        *v = parse_hex(tok + 2);
+        return 2;
+    case Symbol:
+        if (get_reg(reg, token, "register or value"))
+            return 1;
+        break;
+    case EndL:
+    case EndF:
+        ASM_ERROR("%d: error: register or value required\n", curline);
+        return 0;
+    }
+    ASM_ERROR("%d: error: register or value required: %s\n", curline, token_str());
+    if (token != EndL) skip_line();
+    return 0;
+}
+
+void write_code(int code)
+{
+    out_word(curad, (uint32_t)code, 0);
+    curad += 4;
+    if (curad > text_end) text_end = curad;
+}
+
+void assemble_pcd(int op1, int num)
+{
+    if (op1 < 0 || op1 > 0x3f)
+        ASM_ERROR("%d: error: opcode is over 6bit: %x\n", curline, op1);
+    else if (num < 0 || num > 0x03ffffff)
+        ASM_ERROR("%d: error: num is over 26bit: %x\n", curline, num);
+    else
+        write_code((op1 << 26) | num);
+}
+
+void assemble_bra(enum Op op, enum Regs ra, int disp)
+{
+    int op1 = ((int)op) >> 16 << 26;
+    if (check_bra_disp(disp))
+        write_code(op1 | (((int)ra) << 21) | (((unsigned int)disp) & 0x1fffff));
+}
+
+void assemble_mem(enum Op op, enum Regs ra, enum Regs rb, int disp)
+{
+    int op1 = ((int)op) >> 16 << 26;
+    if (disp < -0x8000)
+        ASM_ERROR("%d: error: disp < -0x8000: -%x\n", curline, -disp);
+    else if (disp > 0x7fff)
+        ASM_ERROR("%d: error: disp > 0x7fff: %x\n", curline, disp);
+    else
+        write_code(op1 | (((int)ra) << 21) | (((int)rb) << 16) | (uint16_t)(int16_t)disp);
+}
+
+void assemble_mfc(enum Op op, enum Regs ra, enum Regs rb)
+{
+    int op1 = ((int)op) >> 16 << 26, op2 = ((int)op) & 0xffff;
+    write_code(op1 | (((int)ra) << 21) | (((int)rb) << 16) | op2);
+}
+
+void assemble_mbr(enum Op op, enum Regs ra, enum Regs rb, int hint)
+{
+    int op1 = ((int)op) >> 16 << 26, op2 = (((int)op) & 3) << 14;
+    if (hint < 0 || hint > 0x3fff)
+        ASM_ERROR("%d: error: hint is over 14bit: %x\n", curline, hint);
+    else
+        write_code(op1 | (((int)ra) << 21) | (((int)rb) << 16) | op2 | hint);
+}
+
+void assemble_opr(enum Op op, enum Regs ra, enum Regs rb, enum Regs rc)
+{
+    int op1 = ((int)op) >> 16 << 26, op2 = (((int)op) & 0x7f) << 5;
+    write_code(op1 | (((int)ra) << 21) | (((int)rb) << 16) | op2 | (int)rc);
+}
+
+void assemble_opr_value(enum Op op, enum Regs ra, int vb, enum Regs rc)
+{
+    int op1 = ((int)op) >> 16 << 26, op2 = (((int)op) & 0x7f) << 5;
+    if (vb < 0 || vb > 255)
+        ASM_ERROR("%d: error: literal is over 8bit: %x\n", curline, vb);
+    else
+        write_code(op1 | (((int)ra) << 21) | (vb << 13) | 0x1000 | op2 | (int)rc);
+}
+
+void assemble_fp(enum Op op, enum Regs fa, enum Regs fb, enum Regs fc)
+{
+    int op1 = ((int)op) >> 16 << 26, op2 = (((int)op) & 0x7ff) << 5;
+    write_code(op1 | (((int)fa) << 21) | (((int)fb) << 16) | op2 | (int)fc);
+}
+
+void parse_bra(enum Op op)
+{
+    enum Token token = read_token();
+    enum Regs ra;
+    if (token == Symbol && parse_reg(&ra, tok, toklen))
+    {
+        read_sign(",");
+        token = read_token();
+    }
+    else
+    {
+        if (op != Br)
+        {
+            ASM_ERROR("%d: error: register required: %s\n", curline, token_str());
+            return;
+        }
+        ra = Zero;
+    }
+    switch (token)
+    {
+    case Hex:
+    case Symbol:
+        {
+            int64_t ad1 = (int64_t)(curad + 4), ad2;
+            int diff;
+            if (token == Hex)
+                ad2 = (int64_t)parse_hex(tok + 2);
+            else
+            {
+                int l = find_label(tok, toklen);
+                if (l < 0) break;
+                if (!labels[l].defined)
+                {
+                    add_fixup(l);
+                    assemble_bra(op, ra, 0);
+                    break;
+                }
+                ad2 = (int64_t)labels[l].addr;
+            }
+            diff = (int)(ad2 - ad1);
+            if ((diff & 3) != 0)
+                ASM_ERROR("%d: error: not align 4: %s\n", curline, token_str());
+            else
+                assemble_bra(op, ra, diff >> 2);
+            break;
+        }
+    default:
+        ASM_ERROR("%d: error: address or label required: %s\n", curline, token_str());
+        break;
+    }
+}
+
+void parse_mov()
+{
+    enum Regs ra, rb;
+    if (read_reg(&ra, 0) && read_sign(",") && read_reg(&rb, 0))
+        assemble_opr(Bis, Zero, ra, rb);
+}
+
+void parse_mem(enum Op op)
+{
+    enum Regs ra, rb;
+    int disp;
+    switch (op)
+    {
+    case Unop:
+        assemble_mem(op, Zero, Zero, 0);
+        break;
+    case Prefetch:
+    case Prefetch_en:
+    case Prefetch_m:
+    case Prefetch_men:
+        if (parse_addr(&rb, &disp))
+            assemble_mem(op, Zero, rb, disp);
+        break;
+    default:
+        if (read_reg(&ra, 0) && read_sign(",") && parse_addr(&rb, &disp))
+            assemble_mem(op, ra, rb, disp);
+        break;
+    }
+}
+
+void parse_mfc(enum Op op)
+{
+    enum Regs ra, rb;
+    if (read_reg(&ra, 0) && read_sign(",") && read_reg(&rb, 0))
+        assemble_mfc(op, ra, rb);
+}
+
+void parse_mbr(enum Op op)
+{
+    enum Regs ra, rb;
+    uint64_t hint;
+    enum Token token = read_token();
+    if (op == Ret && (token == EndL || token == EndF))
+        assemble_mbr(op, Zero, RA, 1);
+    else if (get_reg(&ra, token, 0)
+        && read_sign(",") && read_sign("(") && read_reg(&rb, 0) && read_sign(")")
+        && read_sign(",") && parse_value(&hint))
+        assemble_mbr(op, ra, rb, (int)hint);
+}
+
+void parse_opr_2(enum Op op, enum Regs ra)
+{
+    enum Regs rb, rc;
+    uint64_t vb;
+    int t;
+    if ((t = parse_reg_or_value(&rb, &vb)) != 0 && read_sign(",") && read_reg(&rc, 0))
+    {
+        if (t == 1)
+            assemble_opr(op, ra, rb, rc);
+        else
+            assemble_opr_value(op, ra, (int)vb, rc);
+    }
+}
+
+void parse_opr(enum Op op)
+{
+    enum Regs ra;
+    if (read_reg(&ra, 0) && read_sign(","))
+        parse_opr_2(op, ra);
+}
+
+void parse_fp(enum Op op)
+{
+    enum Regs fa, fb, fc;
+    enum Token token;
+    if (!read_reg(&fa, 0)) return;
+    token = read_token();
+    if ((token == EndL || token == EndF) && (op == Mf_fpcr || op == Mt_fpcr))
+        assemble_fp(op, fa, fa, fa);
+    else if (is_sign(token, ",") && read_reg(&fb, 0) && read_sign(",") && read_reg(&fc, 0))
+        assemble_fp(op, fa, fb, fc);
+}
+
+void assemble_pop(enum POp pop)
+{
+    switch (pop)
+    {
+    case Mov:
+        parse_mov();
+        break;
+    case Nop:
+        assemble_opr(Bis, Zero, Zero, Zero);
+        break;
+    case Clr:
+        {
+            enum Regs rc;
+            if (read_reg(&rc, 0))
+                assemble_opr(Bis, Zero, Zero, rc);
+            break;
+        }
+    case Sextl:
+    case Not:
+    case Negl:
+    case Negl__v:
+    case Negq:
+    case Negq__v:
+        parse_opr_2(popcodes[(int)pop], Zero);
+        break;
+    case Fnop:
+        assemble_fp(Cpys, Zero, Zero, Zero);
+        break;
+    case Fclr:
+        {
+            enum Regs fc;
+            if (read_reg(&fc, 0))
+                assemble_fp(Cpys, Zero, Zero, fc);
+            break;
+        }
+    case Fabs:
+    case Negf:
+    case Negf__s:
+    case Negg:
+    case Negg__s:
+    case Negs:
+    case Negs__su:
+    case Negs__sui:
+    case Negt:
+    case Negt__su:
+    case Negt__sui:
+        {
+            enum Regs fb, fc;
+            if (read_reg(&fb, 0) && read_sign(",") && read_reg(&fc, 0))
+                assemble_fp(popcodes[(int)pop], Zero, fb, fc);
+            break;
+        }
+    case Fmov:
+    case Fneg:
+        {
+            enum Regs fb, fc;
+            if (read_reg(&fb, 0) && read_sign(",") && read_reg(&fc, 0))
+                assemble_fp(popcodes[(int)pop], fb, fb, fc);
+            break;
+        }
+    }
+}
+
+void assemble_op(enum Op op)
+{
+    int op1 = ((int)op) >> 16;
+    switch (formats[op1])
+    {
+    case Bra: parse_bra(op); break;
+    case Mem: parse_mem(op); break;
+    case Mfc: parse_mfc(op); break;
+    case Mbr: parse_mbr(op); break;
+    case Opr: parse_opr(op); break;
+    case F_P: parse_fp (op); break;
+    default:
+        {
+            uint64_t num;
+            if (parse_value(&num)) assemble_pcd(op1, (int)num);
+            break;
+        }
+    }
+}
+
+/* .long and .quad: values separated by commas, as 7d writes data */
+int assemble_data()
+{
+    int quad;
+    if (read_token() != Symbol || toklen != 4) return 0;
+    if (LOWER(tok[0]) == 'q' && LOWER(tok[1]) == 'u' && LOWER(tok[2]) == 'a' && LOWER(tok[3]) == 'd')
+        quad = 1;
+    else if (LOWER(tok[0]) == 'l' && LOWER(tok[1]) == 'o' && LOWER(tok[2]) == 'n' && LOWER(tok[3]) == 'g')
+        quad = 0;
+    else
+        return 0;
+    for (;;)
+    {
+        uint64_t v;
+        enum Token token;
+        if (!parse_value(&v)) return 1;
+        write_code((int)(uint32_t)v);
+        if (quad) write_code((int)(uint32_t)(v >> 32));
+        token = read_token();
+        if (token == EndL || token == EndF) return 1;
+        if (token != Sign || *tok != ',')
+        {
+            ASM_ERROR("%d: error: ',' required: %s\n", curline, token_str());
+            skip_line();
+            return 1;
+        }
+    }
+}
+
+int assemble_token(enum Token token)
+{
+    switch (token)
+    {
+    case Sign:
+        return *tok == '.' && assemble_data();
+    case Addr:
+        {
+            uint64_t h = parse_hex(tok + 2);
+            if (curad == 0) text_start = h;
+            curad = h;
+            if (curad > text_end) text_end = curad;
+            return 1;
+        }
+    case EndL:
+        return 1;
+    case Label:
+        define_label(tok, toklen);
+        return 1;
+    case Symbol:
+        {
+            int opn = search_mnemonic(tok, toklen);
+            if (opn > 0)
+                assemble_op(opcodes[opn]);
+            else if (opn < 0)
+                assemble_pop((enum POp)~opn);
+            else if (LOWER(tok[0]) == 'o' && LOWER(tok[1]) == 'p' && LOWER(tok[2]) == 'c')
+            {
+                int op1 = (int)parse_uint(tok + 3);
+                uint64_t num;
+                if (!parse_value(&num)) return 0;
+                assemble_pcd(op1, (int)num);
+            }
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void assemble_lines()
+{
+    enum Token token;
+    for (;;)
+    {
+        curline = line;
+        token = read_token();
+        if (token == EndF) break;
+        if (!assemble_token(token))
+        {
+            ASM_ERROR("%d: error: %s\n", curline, token_str());
+            skip_line();
+        }
+    }
+}
@@ -0,0 +1,222 @@
+/* ELF64 reader: the whole file is mapped (read into memory on Alpha and
+   VC++) and headers and section contents are returned as views into it */
+
+struct Elf64_Ehdr
+{
+    unsigned char e_ident[16];
+    uint16_t e_type, e_machine;
+    uint32_t e_version;
+    uint64_t e_entry, e_phoff, e_shoff;
+    uint32_t e_flags;
+    uint16_t e_ehsize, e_phentsize, e_phnum, e_shentsize, e_shnum, e_shstrndx;
+};
+
+struct Elf64_Phdr
+{
+    uint32_t p_type, p_flags;
+    uint64_t p_offset, p_vaddr, p_paddr, p_filesz, p_memsz, p_align;
+};
+
+struct Elf64_Shdr
+{
+    uint32_t sh_name, sh_type;
+    uint64_t sh_flags, sh_addr, sh_offset, sh_size;
+    uint32_t sh_link, sh_info;
+    uint64_t sh_addralign, sh_entsize;
+};
+
+struct Elf64_Sym
+{
+    uint32_t st_name;
+    unsigned char st_info, st_other;
+    uint16_t st_shndx;
+    uint64_t st_value, st_size;
+};
+
+struct Elf
+{
+    char *data;
+    uint64_t size;
+    const struct Elf64_Ehdr *ehdr;
+    const struct Elf64_Phdr *phdrs;
+    const struct Elf64_Shdr *shdrs;
+    const char *shstrtab;
+    uint64_t shstrsize;
+};
+
+#if defined(__alpha) || defined(_MSC_VER)
+int elf_load(struct Elf *elf, const char *fn)
+{
+    uint64_t cap = 65536;
+    int n;
+    FILE *f = fopen(fn, "rb");
+    if (!f) return 0;
+    elf->data = (char *)malloc(cap);
+    while (elf->data && (n = fread(elf->data + elf->size, 1, (int)(cap - elf->size), f)) > 0)
+    {
+        elf->size += n;
+        if (elf->size == cap) elf->data = (char *)realloc(elf->data, cap *= 2);
+    }
+    fclose(f);
+    return elf->data != 0;
+}
+
+void elf_unload(struct Elf *elf)
+{
+    free(elf->data);
+}
+#else
+int elf_load(struct Elf *elf, const char *fn)
+{
+    long size;
+    int fd = open(fn, 0 /* O_RDONLY */);
+    if (fd < 0) return 0;
+    size = lseek(fd, 0, 2 /* SEEK_END */);
+    if (size > 0)
+    {
+        void *p = mmap(0, size, 1 /* PROT_READ */, 2 /* MAP_PRIVATE */, fd, 0);
+        if (p != (void *)-1)
+        {
+            elf->data = (char *)p;
+            elf->size = (uint64_t)size;
+        }
+    }
+    close(fd);
+    return elf->data != 0;
+}
+
+void elf_unload(struct Elf *elf)
+{
+    munmap(elf->data, (unsigned long)elf->size);
+}
+#endif
+
+void elf_close(struct Elf *elf)
+{
+    if (elf->data) elf_unload(elf);
+    memset(elf, 0, sizeof(*elf));
+}
+
+const char *elf_contents(struct Elf *elf, const struct Elf64_Shdr *sh)
+{
+    if (sh->sh_offset > elf->size || sh->sh_size > elf->size - sh->sh_offset) return 0;
+    return elf->data + sh->sh_offset;
+}
+
+const struct Elf64_Shdr *elf_section(struct Elf *elf, const char *name)
+{
+    int i;
+    for (i = 0; i < elf->ehdr->e_shnum; i++)
+    {
+        const struct Elf64_Shdr *sh = &elf->shdrs[i];
+        if (sh->sh_name < elf->shstrsize && strcmp(elf->shstrtab + sh->sh_name, name) == 0)
+            return sh;
+    }
+    return 0;
+}
+
+/* the file contents at the address [ad, ad + size) of an allocated
+   section, 0 when the address is not backed by the file */
+const char *elf_address(struct Elf *elf, uint64_t ad, uint64_t size)
+{
+    int i;
+    for (i = 0; i < elf->ehdr->e_shnum; i++)
+    {
+        const struct Elf64_Shdr *sh = &elf->shdrs[i];
+        const char *p;
+        if ((sh->sh_flags & 2 /* SHF_ALLOC */) && sh->sh_type != 8 /* SHT_NOBITS */
+            && ad >= sh->sh_addr && ad - sh->sh_addr <= sh->sh_size
+            && size <= sh->sh_size - (ad - sh->sh_addr) && (p = elf_contents(elf, sh)) != 0)
+            return p + (ad - sh->sh_addr);
+    }
+    return 0;
+}
+
+/* .symtab and its string table, 0 when the file is stripped */
+const struct Elf64_Sym *elf_symtab(struct Elf *elf, int *count, const char **strtab, uint64_t *strsize)
+{
+    const struct Elf64_Sym *syms;
+    const struct Elf64_Shdr *sh = 0, *str;
+    int i;
+    for (i = 0; i < elf->ehdr->e_shnum && !sh; i++)
+        if (elf->shdrs[i].sh_type == 2 /* SHT_SYMTAB */) sh = &elf->shdrs[i];
+    if (!sh || sh->sh_entsize != sizeof(struct Elf64_Sym) || (sh->sh_offset & 7) != 0
+        || sh->sh_link >= elf->ehdr->e_shnum
+        || !(syms = (const struct Elf64_Sym *)elf_contents(elf, sh)))
+        return 0;
+    str = &elf->shdrs[sh->sh_link];
+    if (str->sh_size == 0 || !(*strtab = elf_contents(elf, str))
+        || (*strtab)[str->sh_size - 1] != 0)
+        return 0;
+    *strsize = str->sh_size;
+    *count = (int)(sh->sh_size / sizeof(struct Elf64_Sym));
+    return syms;
+}
+
+int elf_check(struct Elf *elf)
+{
+    const struct Elf64_Ehdr *eh = (const struct Elf64_Ehdr *)elf->data;
+    const struct Elf64_Shdr *sh;
+    if (elf->size < sizeof(struct Elf64_Ehdr))
+    {
+        printf("can not read ELF header.\n");
+        return 0;
+    }
+    if (eh->e_ident[0] != 0x7f || eh->e_ident[1] != 'E' || eh->e_ident[2] != 'L' || eh->e_ident[3] != 'F')
+    {
+        printf("EI_MAG != { 0x7f, 'E', 'L', 'F' }\n");
+        return 0;
+    }
+    if (eh->e_ident[4] != 2)
+    {
+        printf("EI_CLASS != ELFCLASS64\n");
+        return 0;
+    }
+    if (eh->e_ident[5] != 1)
+    {
+        printf("EI_DATA != ELFDATA2LSB\n");
+        return 0;
+    }
+    if (eh->e_shoff == 0)
+    {
+        printf("e_shoff == 0\n");
+        return 0;
+    }
+    if (eh->e_shstrndx == 0)
+    {
+        printf("e_shstrndx == 0\n");
+        return 0;
+    }
+    if (eh->e_shentsize != sizeof(struct Elf64_Shdr) || (eh->e_shoff & 7) != 0
+        || eh->e_shoff > elf->size
+        || (elf->size - eh->e_shoff) / sizeof(struct Elf64_Shdr) < eh->e_shnum)
+    {
+        printf("can not read section headers\n");
+        return 0;
+    }
+    elf->ehdr = eh;
+    elf->shdrs = (const struct Elf64_Shdr *)(elf->data + eh->e_shoff);
+    sh = eh->e_shstrndx < eh->e_shnum ? &elf->shdrs[eh->e_shstrndx] : 0;
+    if (!sh || sh->sh_size == 0
+        || !(elf->shstrtab = elf_contents(elf, sh))
+        || elf->shstrtab[sh->sh_size - 1] != 0)
+    {
+        printf("can not read shstrtab\n");
+        return 0;
+    }
+    elf->shstrsize = sh->sh_size;
+    if (eh->e_phoff != 0 && eh->e_phentsize == sizeof(struct Elf64_Phdr)
+        && (eh->e_phoff & 7) == 0 && eh->e_phoff <= elf->size
+        && (elf->size - eh->e_phoff) / sizeof(struct Elf64_Phdr) >= eh->e_phnum)
+        elf->phdrs = (const struct Elf64_Phdr *)(elf->data + eh->e_phoff);
+    return 1;
+}
+
+int elf_open(struct Elf *elf, const char *fn)
+{
+    memset(elf, 0, sizeof(*elf));
+    if (!elf_load(elf, fn)) return 0;
+    if (elf_check(elf)) return 1;
+    elf_close(elf);
+    return 0;
+}
@@ -0,0 +1,71 @@
+/* malloc/realloc/free for the Alpha libc: blocks are bumped off a
+   16 MiB static arena, each after a header word holding its size in
+   words. A freed block on top of the arena lowers the top, any other
+   goes to a free list and is reused whole by a later malloc of at most
+   its size, so realloc moving a block does not leak the old one */
+
+uint64_t heap[(16 << 20) / 8], *heap_top = heap, *heap_free;
+
+void *malloc(unsigned long size)
+{
+    uint64_t *p, **q, n = (size + 7) / 8 + 1;
+    if (n < 2) n = 2;  /* room for the free list link */
+    for (q = &heap_free; *q; q = (uint64_t **)&(*q)[1])
+    {
+        if (**q >= n)
+        {
+            p = *q;
+            *q = (uint64_t *)p[1];
+            return p + 1;
+        }
+    }
+    p = heap_top;
+    if (n > (uint64_t)(heap + sizeof(heap) / 8 - p)) return 0;
+    *p = n;
+    heap_top = p + n;
+    return p + 1;
+}
+
+void free(void *ptr)
+{
+    uint64_t *p = (uint64_t *)ptr - 1, **q;
+    if (!ptr) return;
+    if (p + *p != heap_top)
+    {
+        p[1] = (uint64_t)heap_free;
+        heap_free = p;
+        return;
+    }
+    heap_top = p;
+    /* free blocks which are now on top lower it further */
+    for (q = &heap_free; *q;)
+    {
+        if (*q + **q == heap_top)
+        {
+            heap_top = *q;
+            *q = (uint64_t *)(*q)[1];
+            q = &heap_free;
+        }
+        else
+            q = (uint64_t **)&(*q)[1];
+    }
+}
+
+void *realloc(void *ptr, unsigned long size)
+{
+    uint64_t *p = (uint64_t *)ptr - 1, *q, n = (size + 7) / 8 + 1, i;
+    if (!ptr) return malloc(size);
+    if (n < 2) n = 2;
+    if (p + *p == heap_top)
+    {
+        if (n > (uint64_t)(heap + sizeof(heap) / 8 - p)) return 0;
+        *p = n;
+        heap_top = p + n;
+        return ptr;
+    }
+    if (n <= *p) return ptr;
+    if (!(q = (uint64_t *)malloc(size))) return 0;
+    for (i = 1; i < *p; i++) q[i - 1] = p[i];
+    free(ptr);
+    return q;
+}
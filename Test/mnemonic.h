@@ -0,0 +1,579 @@
+/* generated by 7a --mnemonics from alpha.def, do not edit */
+
+typedef char mne_count_check[MNE_COUNT == 545 ? 1 : -1];
+
+const uint32_t mne_disp[MNE_BUCKETS] =
+{
+    0, 3, 6, 0, 0, 3, 0, 0, 0, 3, 0, 0,
+    0, 0, 2, 1, 0, 6, 3, 0, 1, 3, 0, 0,
+    0, 4, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0,
+    0, 0, 0, 1, 2, 2, 0, 1, 7, 0, 0, 4,
+    0, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0,
+    0, 0, 1, 0, 0, 29, 0, 0, 0, 1, 0, 2,
+    0, 4, 1, 5, 0, 0, 0, 6, 2, 2, 2, 12,
+    0, 1, 0, 0, 3, 2, 0, 0, 0, 0, 0, 1,
+    0, 0, 0, 0, 0, 0, 0, 3, 4, 6, 0, 0,
+    0, 0, 1, 0, 0, 1, 1, 1, 2, 1, 4, 0,
+    0, 0, 2, 1, 0, 0, 2, 0, 0, 1, 0, 0,
+    2, 1, 2, 0, 0, 0, 11, 2, 0, 0, 3, 0,
+    0, 4, 0, 2, 6, 5, 0, 0, 1, 1, 0, 0,
+    0, 1, 1, 5, 0, 0, 0, 3, 2, 5, 2, 2,
+    2, 6, 4, 0, 0, 1, 0, 3, 2, 0, 0, 0,
+    1, 4, 0, 0, 0, 2, 1, 0, 1, 0, 1, 4,
+    0, 6, 3, 7, 7, 0, 1, 1, 0, 6, 5, 0,
+    0, 2, 0, 5, 1, 1, 0, 0, 2, 3, 0, 2,
+    0, 2, 3, 8, 6, 4, 0, 1, 2, 0, 2, 15,
+    0, 5, 0, 1, 0, 0, 3, 1, 2, 2, 0, 1,
+    4, 2, 3, 1, 2, 0, 1, 0, 0, 0, 2, 1,
+    3, 3, 0, 1,
+};
+
+/* opnames index, ~popnames index, 0: empty */
+const short mne_slot[1 << MNE_BITS] =
+{
+    [1] = I_Mult__c,
+    [2] = I_Subs__suim,
+    [3] = I_Xor,
+    [6] = I_Sqrtg,
+    [7] = I_Divs__sui,
+    [8] = I_Sqrtg__s,
+    [9] = I_Cvttq__sv,
+    [11] = I_Subs__d,
+    [17] = ~Not,
+    [18] = I_Sra,
+    [22] = I_Muls__sui,
+    [23] = I_Zapnot,
+    [24] = I_Pal1d,
+    [27] = I_Pklb,
+    [28] = I_Adds__suc,
+    [29] = ~Negt__su,
+    [30] = I_Subg__sc,
+    [31] = I_Cvtgf,
+    [34] = I_Addf__c,
+    [38] = I_Adds__c,
+    [40] = I_Subt__u,
+    [41] = I_Divt__sum,
+    [44] = I_Inslh,
+    [45] = I_Subt__d,
+    [46] = I_Pal19,
+    [48] = I_Subt__suic,
+    [50] = I_Addg__s,
+    [53] = I_Zap,
+    [54] = I_Mulg__uc,
+    [55] = I_Sqrtt__uc,
+    [56] = I_Mull__v,
+    [57] = I_Extll,
+    [58] = I_Cvtgf__su,
+    [59] = I_Divs__u,
+    [60] = I_Mulg__c,
+    [62] = I_Muls__u,
+    [64] = I_Cmovgt,
+    [66] = I_Subg__u,
+    [68] = I_Addg__sc,
+    [69] = I_Adds__suic,
+    [70] = I_Cvtgq__s,
+    [73] = I_Sqrtg__u,
+    [76] = I_Mulf__su,
+    [81] = I_Insll,
+    [82] = I_Adds__um,
+    [83] = I_Cmpgeq,
+    [85] = I_Sqrtf__su,
+    [88] = I_Cvtts__u,
+    [89] = I_Cvtgd__su,
+    [91] = I_Subs__m,
+    [92] = I_Sqrtt__suc,
+    [93] = I_Adds__sui,
+    [94] = I_Cvtts__sum,
+    [95] = I_Sqrtt__c,
+    [96] = I_Cpyse,
+    [97] = I_Stq_c,
+    [103] = I_Cvtgq__v,
+    [105] = I_Divs__um,
+    [106] = I_Sqrtg__sc,
+    [108] = I_Divf__su,
+    [109] = I_Addt__um,
+    [114] = I_Opc02,
+    [115] = ~Negf,
+    [117] = I_Ldl_l,
+    [119] = I_Addq,
+    [120] = I_Fcmovgt,
+    [122] = I_Itoft,
+    [123] = I_Divt__suid,
+    [125] = I_Divs__c,
+    [126] = I_Pal1b,
+    [127] = I_Subt__suid,
+    [128] = I_Cmpteq__su,
+    [130] = I_Cvtts__suim,
+    [131] = I_Addt__su,
+    [133] = ~Negq__v,
+    [136] = I_Addt__uc,
+    [137] = I_Unop,
+    [141] = I_Cvttq__m,
+    [143] = ~Sextl,
+    [144] = I_Mult,
+    [146] = I_Adds__d,
+    [147] = I_Sqrtf__s,
+    [148] = I_Cvtts__uc,
+    [150] = I_Cvtqs__suim,
+    [151] = I_Ldbu,
+    [152] = I_S8addl,
+    [153] = I_Sqrts__sui,
+    [156] = I_Opc07,
+    [157] = I_Divs__d,
+    [158] = I_Subt__sui,
+    [159] = I_Mult__sud,
+    [160] = I_Minuw4,
+    [161] = I_Addl,
+    [163] = ~Fnop,
+    [164] = I_Divf__suc,
+    [165] = ~Nop,
+    [167] = I_Divt__d,
+    [169] = I_Cvtgd__c,
+    [170] = I_Addl__v,
+    [175] = I_Divg__uc,
+    [179] = I_Sqrtt__u,
+    [180] = I_Cvttq__svd,
+    [181] = I_Stq_u,
+    [189] = I_Prefetch,
+    [190] = I_Sqrts__sum,
+    [193] = I_Cvtqt__m,
+    [194] = I_Cvtts,
+    [195] = I_Cvtql,
+    [196] = I_Subq,
+    [197] = I_Divf__c,
+    [199] = I_Addg__c,
+    [200] = I_Subt__su,
+    [201] = I_Subf,
+    [202] = I_Addt__m,
+    [203] = I_Cvtgf__u,
+    [204] = I_Cvtdg__s,
+    [205] = I_Sqrtt__suid,
+    [207] = I_Subf__suc,
+    [208] = I_Divf__uc,
+    [209] = I_Mulg__s,
+    [212] = I_Addt__c,
+    [214] = I_Wmb,
+    [215] = ~Negg__s,
+    [216] = I_Subs__suic,
+    [217] = I_Cvttq__svid,
+    [218] = I_Cvtql__v,
+    [219] = I_Mulg__u,
+    [220] = I_Umulh,
+    [222] = ~Fabs,
+    [225] = I_Muls__suim,
+    [226] = I_Muls__sum,
+    [228] = I_Adds__sud,
+    [231] = I_Cmptle,
+    [232] = I_Divs__suim,
+    [234] = I_Cvtgd__u,
+    [237] = I_Mulq__v,
+    [238] = I_Bne,
+    [239] = I_Cvtdg,
+    [242] = I_Cvtlq,
+    [245] = I_Addg__su,
+    [250] = I_Cvtgq__svc,
+    [252] = I_Cvtqs__suic,
+    [255] = I_Divg__c,
+    [259] = I_Opc05,
+    [262] = I_Minsw4,
+    [264] = I_And,
+    [265] = I_Addf__suc,
+    [268] = I_Addf__uc,
+    [269] = I_Opc03,
+    [270] = I_Bge,
+    [271] = I_Mt_fpcr,
+    [272] = I_Muls__suic,
+    [273] = I_Sqrtt__sud,
+    [277] = I_Sqrtt__d,
+    [278] = I_Adds__suid,
+    [280] = I_Subs__sud,
+    [281] = I_Ftoit,
+    [282] = I_Ldah,
+    [283] = I_Divt__uc,
+    [284] = I_Mulf,
+    [287] = I_Divg__sc,
+    [292] = I_Sqrts__u,
+    [294] = I_Subl__v,
+    [295] = I_Mskwh,
+    [299] = I_Cvtqs__sui,
+    [300] = I_Mskqh,
+    [301] = I_Fcmovne,
+    [302] = I_Cmpgeq__s,
+    [303] = I_Cvttq__v,
+    [304] = I_Cmpeq,
+    [306] = I_Cvttq__vm,
+    [308] = I_Mf_fpcr,
+    [309] = I_Fcmovge,
+    [316] = I_Cmpglt__s,
+    [319] = I_Minsb8,
+    [321] = I_Divt__u,
+    [322] = I_Itofs,
+    [324] = I_Divs__ud,
+    [329] = ~Negs__su,
+    [330] = I_Ble,
+    [333] = I_Inswl,
+    [334] = I_Mulf__s,
+    [336] = ~Mov,
+    [340] = I_Wh64,
+    [342] = I_S4addq,
+    [344] = I_Muls,
+    [345] = I_Eqv,
+    [348] = I_Cmoveq,
+    [350] = I_Subs__suc,
+    [352] = I_Cvttq__svm,
+    [353] = I_Divg,
+    [355] = I_Subg,
+    [356] = I_Insqh,
+    [357] = I_Call_pal,
+    [358] = I_Ldwu,
+    [359] = I_Bis,
+    [362] = ~Negg,
+    [364] = I_Mult__m,
+    [365] = I_Addt__sum,
+    [366] = I_Subt__c,
+    [367] = I_Divt__suc,
+    [368] = I_Subt__sud,
+    [370] = I_Mskbl,
+    [371] = I_Addg,
+    [376] = I_Ornot,
+    [377] = I_Mult__um,
+    [381] = I_Sqrts__su,
+    [383] = I_Adds__u,
+    [385] = I_Cmpule,
+    [387] = I_Trapb,
+    [388] = I_Cvtql__sv,
+    [389] = I_Cvttq__svi,
+    [394] = I_Insql,
+    [395] = I_Divt__sui,
+    [399] = I_Divs__su,
+    [402] = I_Addt__sui,
+    [404] = I_Cvtdg__su,
+    [405] = I_Pal1f,
+    [408] = I_Cmovne,
+    [409] = I_Blbs,
+    [410] = I_Divt__sud,
+    [411] = I_Addg__suc,
+    [415] = I_Cvtgd__sc,
+    [416] = I_Mult__sui,
+    [421] = I_Wh64en,
+    [422] = I_Mult__suic,
+    [423] = I_Divt__um,
+    [426] = I_S4subq,
+    [432] = I_Cvtqs,
+    [434] = I_Sqrts,
+    [435] = I_Divf__sc,
+    [436] = I_Sqrts__d,
+    [437] = I_Subs__ud,
+    [438] = ~Negs__sui,
+    [439] = I_Sqrtt,
+    [440] = I_Ldg,
+    [441] = ~Negl,
+    [442] = I_Cttz,
+    [444] = I_Addg__uc,
+    [446] = I_Cvtdg__c,
+    [447] = I_Adds__sum,
+    [450] = I_Adds__suim,
+    [451] = I_Divs__suid,
+    [453] = I_Addf__u,
+    [454] = I_Rpcc,
+    [458] = I_Muls__um,
+    [459] = I_Minub8,
+    [461] = I_Cvtgq__c,
+    [463] = I_Opc01,
+    [465] = I_Prefetch_m,
+    [469] = I_Srl,
+    [473] = ~Negs,
+    [474] = I_Fcmoveq,
+    [475] = I_S8addq,
+    [478] = I_Cvttq__vd,
+    [482] = I_Mskwl,
+    [484] = I_Cvtts__d,
+    [485] = I_Cvtqf__c,
+    [489] = I_Divt__m,
+    [493] = I_Sqrtt__sum,
+    [495] = I_Msklh,
+    [496] = I_Sqrtt__m,
+    [497] = I_Addf__su,
+    [498] = I_S8subq,
+    [500] = I_Cmpbge,
+    [501] = I_Pkwb,
+    [502] = I_Amask,
+    [503] = I_Sqrtf__sc,
+    [505] = I_Muls__d,
+    [506] = I_Cvtqg__c,
+    [507] = I_Addf__sc,
+    [510] = I_Cvtgf__c,
+    [511] = I_Cvtqt,
+    [517] = I_Unpkbw,
+    [518] = I_Addf__s,
+    [519] = I_Rc,
+    [521] = I_Cvtqf,
+    [522] = I_Subg__s,
+    [523] = I_Jsr_coroutine,
+    [525] = I_Fcmovle,
+    [527] = I_Subl,
+    [528] = I_Cvttq__svim,
+    [529] = I_Mulf__u,
+    [530] = I_Cvtts__suic,
+    [535] = I_Sqrts__ud,
+    [536] = I_Cmovlbs,
+    [537] = I_Ldt,
+    [538] = I_Sqrtf__c,
+    [540] = I_Cmpglt,
+    [541] = I_Subt__suim,
+    [542] = I_Insbl,
+    [543] = I_Adds__ud,
+    [546] = ~Negl__v,
+    [547] = I_Implver,
+    [548] = I_Subq__v,
+    [550] = I_Cvtts__suc,
+    [553] = I_Opc04,
+    [554] = I_Sqrtt__suic,
+    [556] = I_Cvtgf__uc,
+    [558] = I_Addt__suic,
+    [559] = I_Divs__suic,
+    [561] = I_Sextb,
+    [562] = I_Sll,
+    [563] = I_Subt__ud,
+    [564] = I_Subs__sui,
+    [565] = I_Subs__suid,
+    [566] = I_Stl,
+    [573] = I_Ctpop,
+    [575] = I_Extwh,
+    [576] = I_Cmovle,
+    [578] = I_Cmptle__su,
+    [579] = I_Mulg__sc,
+    [581] = I_Sqrtt__su,
+    [582] = ~Negf__s,
+    [584] = I_Addt__sud,
+    [585] = I_Divs__sum,
+    [587] = I_Jmp,
+    [588] = I_Mult__u,
+    [589] = ~Negt__sui,
+    [591] = I_Subf__uc,
+    [592] = I_Cvtqt__suim,
+    [594] = I_Fblt,
+    [595] = I_Cvttq,
+    [597] = I_Muls__uc,
+    [598] = I_S4addl,
+    [599] = I_Mult__suim,
+    [600] = I_Perr,
+    [601] = I_Cpys,
+    [602] = I_Cvtqt__suic,
+    [603] = I_Sqrtf__u,
+    [606] = I_Cmpgle__s,
+    [607] = I_Cvtqs__c,
+    [608] = I_Sqrts__m,
+    [609] = I_Stl_c,
+    [610] = I_Sqrtf__uc,
+    [611] = ~Clr,
+    [612] = I_Ldl,
+    [614] = I_Subt__suc,
+    [615] = I_Sqrts__uc,
+    [617] = I_Addf,
+    [618] = I_Cvtqg,
+    [619] = I_Sqrtt__suim,
+    [622] = I_Fcmovlt,
+    [624] = I_Blt,
+    [626] = I_Cmpteq,
+    [628] = I_Addt__suid,
+    [630] = I_Muls__sud,
+    [631] = I_Divg__su,
+    [633] = I_Mulf__c,
+    [635] = I_S4subl,
+    [636] = I_Sqrts__c,
+    [639] = I_Muls__suid,
+    [643] = I_Subt__um,
+    [646] = I_Cvtts__m,
+    [650] = I_Fbeq,
+    [651] = I_Addq__v,
+    [653] = I_Cvtgd__s,
+    [655] = I_Subt__m,
+    [656] = I_Sqrtt__ud,
+    [659] = I_Cvtgf__s,
+    [660] = I_Cvtdg__uc,
+    [662] = I_Adds__su,
+    [663] = I_Cvtgf__sc,
+    [664] = I_Ldq_u,
+    [665] = I_Bgt,
+    [666] = I_Divt__c,
+    [668] = I_Muls__c,
+    [669] = I_Mult__suid,
+    [671] = I_Subg__c,
+    [673] = I_Cmovlt,
+    [677] = I_Muls__su,
+    [678] = I_Muls__m,
+    [680] = I_Cvtdg__u,
+    [681] = I_Divf__s,
+    [682] = I_Divt__su,
+    [683] = I_Muls__suc,
+    [686] = I_Cvtqt__d,
+    [687] = I_Cvttq__vc,
+    [688] = I_Fbge,
+    [689] = I_Mult__ud,
+    [690] = ~Fclr,
+    [691] = I_Divg__u,
+    [692] = I_Sqrtf__suc,
+    [693] = I_Maxsb8,
+    [697] = I_Sqrtg__suc,
+    [698] = I_Addt__suim,
+    [699] = I_Adds__m,
+    [702] = I_Cmovge,
+    [704] = I_Unpkbl,
+    [705] = I_Ecb,
+    [710] = I_Subg__su,
+    [711] = I_Cvtdg__sc,
+    [713] = I_Subf__c,
+    [714] = I_Cmplt,
+    [717] = I_Maxuw4,
+    [721] = I_Subs__uc,
+    [722] = ~Fneg,
+    [724] = I_Extqh,
+    [725] = I_Subt__uc,
+    [727] = I_Subs,
+    [729] = I_Prefetch_en,
+    [731] = I_Cvtts__ud,
+    [733] = I_Divt__suim,
+    [734] = I_Ldq_l,
+    [739] = I_Stg,
+    [746] = I_Mulg__suc,
+    [747] = I_Cvtqs__m,
+    [748] = I_Fbne,
+    [749] = I_Prefetch_men,
+    [752] = I_Sextw,
+    [753] = I_Cvtts__um,
+    [756] = I_Mulf__sc,
+    [757] = ~Negt,
+    [758] = I_Sqrts__suc,
+    [759] = I_Cmptun__su,
+    [761] = I_Cpysn,
+    [762] = I_Bsr,
+    [764] = I_Cvtts__sui,
+    [767] = I_Cvtts__c,
+    [768] = I_Mult__su,
+    [770] = I_Subs__su,
+    [772] = I_Fetch,
+    [777] = I_Cvtgf__suc,
+    [778] = I_Mult__d,
+    [779] = I_Extql,
+    [780] = I_Cvttq__svic,
+    [781] = I_Cmpult,
+    [782] = I_Mskql,
+    [783] = I_Sqrtf,
+    [784] = ~Fmov,
+    [785] = I_Fbgt,
+    [789] = I_Subs__c,
+    [790] = I_Sqrtg__c,
+    [793] = I_Mulf__uc,
+    [795] = I_Ctlz,
+    [798] = I_Subs__u,
+    [799] = I_Cvtgq__sv,
+    [800] = I_Sqrts__sud,
+    [801] = I_Cvttq__c,
+    [804] = I_Cvtgd__uc,
+    [806] = I_Subf__s,
+    [811] = I_Cvtqt__suid,
+    [812] = I_Sqrtg__uc,
+    [815] = I_Ret,
+    [817] = I_Divg__suc,
+    [821] = I_Ldq,
+    [822] = I_Cmptlt__su,
+    [823] = I_Cvtgd,
+    [827] = I_Mb,
+    [828] = I_Sqrtt__um,
+    [830] = I_Excb,
+    [832] = I_Cvtgq__sc,
+    [835] = I_Cmovlbc,
+    [836] = I_Divt__ud,
+    [837] = I_Mulq,
+    [838] = I_Jsr,
+    [840] = I_Divs__uc,
+    [841] = I_Stq,
+    [842] = I_Bic,
+    [843] = I_Subs__sum,
+    [847] = I_Subf__sc,
+    [849] = I_Sqrts__suic,
+    [850] = I_Sts,
+    [851] = I_Divt,
+    [852] = I_Cvtgd__suc,
+    [856] = I_Divs,
+    [857] = I_Fetch_m,
+    [859] = I_Cmptlt,
+    [860] = I_Divs__m,
+    [865] = I_Cvtqt__sui,
+    [866] = I_Maxub8,
+    [868] = I_Cmple,
+    [870] = I_Addt__d,
+    [872] = I_Mult__suc,
+    [874] = I_Divs__suc,
+    [875] = I_Subf__su,
+    [877] = I_Cvtqt__c,
+    [878] = I_Sqrts__suim,
+    [883] = I_Stt,
+    [886] = I_Mulg__su,
+    [888] = I_Stw,
+    [890] = I_Subf__u,
+    [891] = I_Adds__uc,
+    [892] = I_Adds,
+    [893] = I_Blbc,
+    [894] = I_Itoff,
+    [895] = I_Extlh,
+    [897] = I_Subs__um,
+    [899] = I_Cvtts__sud,
+    [901] = I_Sqrts__suid,
+    [903] = I_Pal1e,
+    [907] = I_Divs__sud,
+    [910] = I_Addt__u,
+    [911] = I_Extwl,
+    [913] = I_Addt__ud,
+    [914] = I_Cmptun,
+    [916] = I_Sqrtg__su,
+    [918] = I_Ldf,
+    [919] = I_Subg__suc,
+    [927] = I_Cmpgle,
+    [928] = I_Inswh,
+    [932] = I_Extbl,
+    [933] = I_Divf__u,
+    [934] = I_Opc06,
+    [936] = I_Subt,
+    [939] = I_Sqrtt__sui,
+    [940] = I_Beq,
+    [944] = I_Mull,
+    [946] = I_Cvttq__d,
+    [947] = I_Mulf__suc,
+    [948] = I_Stb,
+    [949] = I_Br,
+    [955] = I_Cvtqs__suid,
+    [958] = I_Cvtgq,
+    [961] = I_Lds,
+    [962] = I_Addt,
+    [967] = ~Negq,
+    [969] = I_Cvtdg__suc,
+    [971] = I_Lda,
+    [978] = I_Subt__sum,
+    [980] = I_Divg__s,
+    [982] = I_Cvtts__suid,
+    [983] = I_Mult__uc,
+    [984] = I_Ftois,
+    [985] = I_Stf,
+    [989] = I_Maxsw4,
+    [990] = I_Fble,
+    [991] = I_Divf,
+    [994] = I_Cvttq__svc,
+    [995] = I_Cvtts__su,
+    [996] = I_Sqrts__um,
+    [998] = I_Mskll,
+    [999] = I_Cvtst,
+    [1000] = I_Cvtgq__vc,
+    [1001] = I_Cvtqs__d,
+    [1002] = I_Rs,
+    [1003] = I_Divt__suic,
+    [1007] = I_Addt__suc,
+    [1009] = I_Addg__u,
+    [1011] = I_Mult__sum,
+    [1014] = I_Mulg,
+    [1017] = I_Cvtst__s,
+    [1021] = I_Muls__ud,
+    [1022] = I_Subg__uc,
+    [1023] = I_S8subl,
+};